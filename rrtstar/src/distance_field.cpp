@@ -0,0 +1,201 @@
+#include "distance_field.h"
+#include <cmath>
+
+using namespace std;
+using namespace SingleIntegrator;
+
+// Squared distance of the cells that are not a source of the transform, finite to keep the parabolas well defined
+#define DISTANCE_FIELD_FAR 1e20
+
+
+// One dimensional squared distance transform of the sampled function f (Felzenszwalb and Huttenlocher)
+static void distanceTransform (const vector<double>& f, int n, vector<double>& d, vector<int>& v, vector<double>& z) {
+
+    int k = 0;
+    v[0] = 0;
+    z[0] = -HUGE_VAL;
+    z[1] = HUGE_VAL;
+
+    for (int q = 1; q < n; q++) {
+        double s = ( (f[q] + (double)q*q) - (f[v[k]] + (double)v[k]*v[k]) )/(2.0*q - 2.0*v[k]);
+        while (s <= z[k]) {
+            k--;
+            s = ( (f[q] + (double)q*q) - (f[v[k]] + (double)v[k]*v[k]) )/(2.0*q - 2.0*v[k]);
+        }
+        k++;
+        v[k] = q;
+        z[k] = s;
+        z[k+1] = HUGE_VAL;
+    }
+
+    k = 0;
+    for (int q = 0; q < n; q++) {
+        while (z[k+1] < q)
+            k++;
+        d[q] = (double)(q - v[k])*(q - v[k]) + f[v[k]];
+    }
+}
+
+
+// Squared distance, in cells, from every cell to the nearest cell with source set
+static void squaredDistanceTransform (vector<bool>& source, vector<int>& numCells, vector<int>& strides, vector<double>& distOut) {
+
+    int numDimensions = numCells.size();
+    int numCellsTotal = source.size();
+
+    distOut.resize (numCellsTotal);
+    for (int k = 0; k < numCellsTotal; k++)
+        distOut[k] = source[k] ? 0.0 : DISTANCE_FIELD_FAR;
+
+    for (int i = 0; i < numDimensions; i++) {
+
+        int n = numCells[i];
+        vector<double> f (n), d (n), z (n+1);
+        vector<int> v (n);
+
+        // Transform every line of cells along dimension i
+        for (int start = 0; start < numCellsTotal; start++) {
+            if ( (start/strides[i]) % n != 0 )
+                continue;
+
+            for (int q = 0; q < n; q++)
+                f[q] = distOut[start + q*strides[i]];
+            distanceTransform (f, n, d, v, z);
+            for (int q = 0; q < n; q++)
+                distOut[start + q*strides[i]] = d[q];
+        }
+    }
+}
+
+
+DistanceField::DistanceField () {
+
+    numDimensions = 0;
+    resolution = 1.0;
+}
+
+
+DistanceField::~DistanceField () {
+
+}
+
+
+int DistanceField::build (region& regionOperatingIn, list<region*>& obstaclesIn, int numDimensionsIn, double resolutionIn) {
+
+    if ( (numDimensionsIn <= 0) || (resolutionIn <= 0.0) )
+        return 0;
+
+    numDimensions = numDimensionsIn;
+    resolution = resolutionIn;
+
+    origin.resize (numDimensions);
+    numCells.resize (numDimensions);
+    strides.resize (numDimensions);
+
+    int numCellsTotal = 1;
+    for (int i = 0; i < numDimensions; i++) {
+        origin[i] = regionOperatingIn.center[i] - regionOperatingIn.size[i]/2.0;
+        numCells[i] = (int)ceil (regionOperatingIn.size[i]/resolution);
+        if (numCells[i] < 1)
+            numCells[i] = 1;
+        strides[i] = numCellsTotal;
+        numCellsTotal *= numCells[i];
+    }
+
+    // Mark the cells that overlap an obstacle, clamping the obstacles to the grid
+    vector<bool> occupied (numCellsTotal, false);
+    vector<int> cellMin (numDimensions), cellMax (numDimensions), cellCurr (numDimensions);
+    for (list<region*>::iterator iter = obstaclesIn.begin(); iter != obstaclesIn.end(); iter++) {
+
+        region *obstacleCurr = *iter;
+
+        for (int i = 0; i < numDimensions; i++) {
+            cellMin[i] = (int)floor ((obstacleCurr->center[i] - obstacleCurr->size[i]/2.0 - origin[i])/resolution);
+            cellMax[i] = (int)floor ((obstacleCurr->center[i] + obstacleCurr->size[i]/2.0 - origin[i])/resolution);
+            if (cellMin[i] < 0)
+                cellMin[i] = 0;
+            if (cellMin[i] > numCells[i] - 1)
+                cellMin[i] = numCells[i] - 1;
+            if (cellMax[i] < 0)
+                cellMax[i] = 0;
+            if (cellMax[i] > numCells[i] - 1)
+                cellMax[i] = numCells[i] - 1;
+            cellCurr[i] = cellMin[i];
+        }
+
+        // Iterate over the block of cells like an odometer
+        while (true) {
+
+            int index = 0;
+            for (int i = 0; i < numDimensions; i++)
+                index += cellCurr[i]*strides[i];
+            occupied[index] = true;
+
+            int i = 0;
+            while ( (i < numDimensions) && (cellCurr[i] == cellMax[i]) ) {
+                cellCurr[i] = cellMin[i];
+                i++;
+            }
+            if (i == numDimensions)
+                break;
+            cellCurr[i]++;
+        }
+    }
+
+    // Distance from the free cells to the occupied ones and from the occupied cells to the free ones
+    vector<bool> vacant (numCellsTotal);
+    for (int k = 0; k < numCellsTotal; k++)
+        vacant[k] = !occupied[k];
+
+    vector<double> distToOccupied, distToFree;
+    squaredDistanceTransform (occupied, numCells, strides, distToOccupied);
+    squaredDistanceTransform (vacant, numCells, strides, distToFree);
+
+    signedDistance.resize (numCellsTotal);
+    for (int k = 0; k < numCellsTotal; k++) {
+        if (occupied[k])
+            signedDistance[k] = -sqrt (distToFree[k])*resolution;
+        else
+            signedDistance[k] = sqrt (distToOccupied[k])*resolution;
+    }
+
+    return 1;
+}
+
+
+int DistanceField::getCellIndex (const double *stateIn) {
+
+    int index = 0;
+
+    for (int i = 0; i < numDimensions; i++) {
+        double cellCurr = floor ((stateIn[i] - origin[i])/resolution);
+        if ( !(cellCurr >= 0.0) || (cellCurr >= numCells[i]) )
+            return -1;
+        index += (int)cellCurr*strides[i];
+    }
+
+    return index;
+}
+
+
+double DistanceField::getSignedDistance (const double *stateIn) {
+
+    int index = getCellIndex (stateIn);
+
+    if ( (index < 0) || signedDistance.empty() )
+        return 0.0;
+
+    return signedDistance[index];
+}
+
+
+double DistanceField::getClearance (const double *stateIn) {
+
+    double distance = getSignedDistance (stateIn);
+
+    if (distance <= 0.0)
+        return distance;
+
+    // Both the point and the obstacle may lie anywhere in their cells
+    return distance - resolution*sqrt ((double)numDimensions);
+}
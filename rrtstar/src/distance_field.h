@@ -0,0 +1,105 @@
+/*!
+ * \file distance_field.h
+ */
+
+#ifndef __RRTS_DISTANCE_FIELD_H_
+#define __RRTS_DISTANCE_FIELD_H_
+
+#include <list>
+#include <vector>
+
+#include "system_single_integrator.h"
+
+
+
+namespace SingleIntegrator {
+
+
+    /*!
+     * \brief Signed distance field over a regular grid
+     *
+     * The operating region is divided into cubic cells of a given resolution.
+     * A cell is occupied if it overlaps an obstacle, where obstacles outside
+     * the grid are projected onto its boundary. Each cell stores the distance
+     * between its center and the center of the nearest occupied cell, or, for
+     * the occupied cells, minus the distance to the nearest free cell. The
+     * distances are computed with the separable exact Euclidean distance
+     * transform of Felzenszwalb and Huttenlocher.
+     */
+    class DistanceField {
+
+        int numDimensions;
+        double resolution;
+
+        std::vector<double> origin;
+        std::vector<int> numCells;
+        std::vector<int> strides;
+
+        // Signed distance of each cell, in world units
+        std::vector<double> signedDistance;
+
+        int getCellIndex (const double *stateIn);
+
+    public:
+
+        /*!
+         * \brief DistanceField constructor
+         *
+         * More elaborate description
+         */
+        DistanceField ();
+
+        /*!
+         * \brief DistanceField destructor
+         *
+         * More elaborate description
+         */
+        ~DistanceField ();
+
+        /*!
+         * \brief Rasterizes the obstacles and computes the distance field
+         *
+         * The number of cells grows with the size of the operating region over
+         * the resolution to the power of the number of dimensions.
+         *
+         * \param regionOperatingIn The region covered by the grid
+         * \param obstaclesIn The list of obstacles
+         * \param numDimensionsIn Dimensionality of the grid
+         * \param resolutionIn The edge length of a cell
+         *
+         */
+        int build (region& regionOperatingIn, std::list<region*>& obstaclesIn, int numDimensionsIn, double resolutionIn);
+
+        /*!
+         * \brief Returns the edge length of a cell
+         *
+         * More elaborate description
+         */
+        double getResolution () {return resolution;}
+
+        /*!
+         * \brief Returns the signed distance stored in the cell of the point
+         *
+         * A positive value means that no obstacle overlaps the cell. Returns
+         * zero for points outside the grid.
+         *
+         * \param stateIn The point, an array of dimension numDimensions
+         *
+         */
+        double getSignedDistance (const double *stateIn);
+
+        /*!
+         * \brief Returns a lower bound on the distance from the point to the obstacles
+         *
+         * The signed distance of the cell minus the diagonal of a cell. The
+         * bound is not positive near the obstacles and outside the grid.
+         *
+         * \param stateIn The point, an array of dimension numDimensions
+         *
+         */
+        double getClearance (const double *stateIn);
+    };
+}
+
+
+#endif
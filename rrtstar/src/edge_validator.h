@@ -0,0 +1,67 @@
+/*!
+ * \file edge_validator.h
+ */
+
+#ifndef __RRTS_EDGE_VALIDATOR_H_
+#define __RRTS_EDGE_VALIDATOR_H_
+
+#include <cmath>
+
+
+
+namespace RRTstar {
+
+
+    /*!
+     * \brief Checks a straight edge with a point collision checker by hierarchical bisection
+     *
+     * Checks the end point and the start point first, then the midpoint of the
+     * edge, then the midpoints of the two halves and so on, until the checked
+     * points are at most resolutionIn apart. Collisions anywhere along the
+     * edge are found after a few checks instead of after all the checks that
+     * precede them in a walk from the start.
+     *
+     * \param checkerIn The object that provides the point collision checker
+     * \param isInCollisionIn The point collision checker, returns true if the point is in collision
+     * \param stateFromIn Start of the edge
+     * \param stateToIn End of the edge
+     * \param numDimensionsIn Dimension of the points
+     * \param resolutionIn Largest distance between two consecutive checked points
+     *
+     */
+    template<class Checker>
+    bool isEdgeInCollision (Checker& checkerIn, bool (Checker::*isInCollisionIn)(double*),
+                            double *stateFromIn, double *stateToIn, int numDimensionsIn, double resolutionIn) {
+
+        if ( (checkerIn.*isInCollisionIn)(stateToIn) || (checkerIn.*isInCollisionIn)(stateFromIn) )
+            return true;
+
+        double distTotal = 0.0;
+        for (int i = 0; i < numDimensionsIn; i++)
+            distTotal += (stateToIn[i] - stateFromIn[i])*(stateToIn[i] - stateFromIn[i]);
+        distTotal = sqrt (distTotal);
+
+        double *stateCurr = new double[numDimensionsIn];
+        bool collisionFound = false;
+
+        // Check the midpoints of the current segments, then halve the segments
+        for (long numSegments = 1; (distTotal/numSegments > resolutionIn) && !collisionFound; numSegments *= 2) {
+            for (long k = 0; (k < numSegments) && !collisionFound; k++) {
+
+                double ratio = (2.0*k + 1.0)/(2.0*numSegments);
+                for (int i = 0; i < numDimensionsIn; i++)
+                    stateCurr[i] = stateFromIn[i] + (stateToIn[i] - stateFromIn[i])*ratio;
+
+                if ((checkerIn.*isInCollisionIn)(stateCurr))
+                    collisionFound = true;
+            }
+        }
+
+        delete [] stateCurr;
+
+        return collisionFound;
+    }
+}
+
+
+#endif
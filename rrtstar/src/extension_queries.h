@@ -0,0 +1,154 @@
+/*!
+ * \file extension_queries.h
+ */
+
+#ifndef __RRTS_EXTENSION_QUERIES_H_
+#define __RRTS_EXTENSION_QUERIES_H_
+
+#include "system_traits.h"
+
+
+
+namespace RRTstar {
+
+
+    /*!
+     * \brief Cost queries between one state and a set of states
+     *
+     * Systems that specialize SystemTraits<System>::batchCostQueries to true
+     * answer each set with one call to System::evaluateExtensionCosts. For
+     * the other systems the queries fall back to evaluateExtensionCost, one
+     * pair of states at a time.
+     */
+    template<class State, class System, bool batchCostQueries = SystemTraits<System>::batchCostQueries>
+    struct ExtensionCostQueries {
+
+        static int evaluateExtensionCosts (System& systemIn, State& stateIn, State** statesIn, int numStatesIn,
+                                           bool fromStateIn, double* costsOut, bool* exactConnectionsOut) {
+
+            for (int k = 0; k < numStatesIn; k++) {
+                exactConnectionsOut[k] = false;
+                if (fromStateIn)
+                    costsOut[k] = systemIn.evaluateExtensionCost (stateIn, *(statesIn[k]), exactConnectionsOut[k]);
+                else
+                    costsOut[k] = systemIn.evaluateExtensionCost (*(statesIn[k]), stateIn, exactConnectionsOut[k]);
+            }
+
+            return 1;
+        }
+    };
+
+
+    template<class State, class System>
+    struct ExtensionCostQueries<State, System, true> {
+
+        static int evaluateExtensionCosts (System& systemIn, State& stateIn, State** statesIn, int numStatesIn,
+                                           bool fromStateIn, double* costsOut, bool* exactConnectionsOut) {
+
+            return systemIn.evaluateExtensionCosts (stateIn, statesIn, numStatesIn, fromStateIn, costsOut, exactConnectionsOut);
+        }
+    };
+
+
+    /*!
+     * \brief Collision queries between one state and a set of states
+     *
+     * Systems that specialize SystemTraits<System>::batchCollisionQueries to
+     * true answer each set with one call to System::extendToStates. For the
+     * other systems the queries fall back to extendTo, one pair of states at
+     * a time.
+     */
+    template<class State, class Trajectory, class System,
+             bool batchCollisionQueries = SystemTraits<System>::batchCollisionQueries>
+    struct ExtensionCollisionQueries {
+
+        static int extendToStates (System& systemIn, State& stateIn, State** statesIn, int numStatesIn,
+                                   bool fromStateIn, Trajectory* trajectoriesOut, bool* exactConnectionsOut, bool* validOut) {
+
+            for (int k = 0; k < numStatesIn; k++) {
+                exactConnectionsOut[k] = false;
+                if (fromStateIn)
+                    validOut[k] = (systemIn.extendTo (stateIn, *(statesIn[k]), trajectoriesOut[k], exactConnectionsOut[k]) > 0);
+                else
+                    validOut[k] = (systemIn.extendTo (*(statesIn[k]), stateIn, trajectoriesOut[k], exactConnectionsOut[k]) > 0);
+            }
+
+            return 1;
+        }
+    };
+
+
+    template<class State, class Trajectory, class System>
+    struct ExtensionCollisionQueries<State, Trajectory, System, true> {
+
+        static int extendToStates (System& systemIn, State& stateIn, State** statesIn, int numStatesIn,
+                                   bool fromStateIn, Trajectory* trajectoriesOut, bool* exactConnectionsOut, bool* validOut) {
+
+            return systemIn.extendToStates (stateIn, statesIn, numStatesIn, fromStateIn,
+                                            trajectoriesOut, exactConnectionsOut, validOut);
+        }
+    };
+
+
+    /*!
+     * \brief Extension queries between one state and a set of states
+     *
+     * The planners issue the cost and collision queries of a set of near
+     * vertices through this class, which answers them with
+     * ExtensionCostQueries and ExtensionCollisionQueries.
+     *
+     * When fromStateIn is true the trajectories start at stateIn and reach
+     * each of the states in statesIn, otherwise they start at each of the
+     * states in statesIn and reach stateIn.
+     */
+    template<class State, class Trajectory, class System>
+    struct ExtensionQueries {
+
+        /*!
+         * \brief Returns the cost of the trajectory between stateIn and each of the states
+         *
+         * More elaborate description
+         *
+         * \param systemIn The dynamical system
+         * \param stateIn The common end state
+         * \param statesIn The other end states, an array of numStatesIn pointers
+         * \param numStatesIn Number of the other end states
+         * \param fromStateIn The direction of the trajectories
+         * \param costsOut The costs, an array of dimension numStatesIn
+         * \param exactConnectionsOut Set to true where the states can be connected exactly
+         *
+         */
+        static int evaluateExtensionCosts (System& systemIn, State& stateIn, State** statesIn, int numStatesIn,
+                                           bool fromStateIn, double* costsOut, bool* exactConnectionsOut) {
+
+            return ExtensionCostQueries<State,System>::evaluateExtensionCosts (systemIn, stateIn, statesIn, numStatesIn,
+                                                                               fromStateIn, costsOut, exactConnectionsOut);
+        }
+
+        /*!
+         * \brief Computes the trajectory between stateIn and each of the states, checking for collision
+         *
+         * More elaborate description
+         *
+         * \param systemIn The dynamical system
+         * \param stateIn The common end state
+         * \param statesIn The other end states, an array of numStatesIn pointers
+         * \param numStatesIn Number of the other end states
+         * \param fromStateIn The direction of the trajectories
+         * \param trajectoriesOut The trajectories, an array of dimension numStatesIn
+         * \param exactConnectionsOut Set to true where the states can be connected exactly
+         * \param validOut Set to true where the trajectory is collision free
+         *
+         */
+        static int extendToStates (System& systemIn, State& stateIn, State** statesIn, int numStatesIn,
+                                   bool fromStateIn, Trajectory* trajectoriesOut, bool* exactConnectionsOut, bool* validOut) {
+
+            return ExtensionCollisionQueries<State,Trajectory,System>::extendToStates (systemIn, stateIn, statesIn, numStatesIn,
+                                                                                       fromStateIn, trajectoriesOut,
+                                                                                       exactConnectionsOut, validOut);
+        }
+    };
+}
+
+
+#endif
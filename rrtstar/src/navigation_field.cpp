@@ -0,0 +1,230 @@
+#include "navigation_field.h"
+#include <cmath>
+#include <functional>
+#include <queue>
+#include <utility>
+
+using namespace std;
+using namespace SingleIntegrator;
+
+
+NavigationField::NavigationField () {
+
+    numDimensions = 0;
+    resolution = 1.0;
+    stretch = 1.0;
+}
+
+
+NavigationField::~NavigationField () {
+
+}
+
+
+int NavigationField::build (region& regionOperatingIn, list<region*>& obstaclesIn, region& regionSourceIn,
+                            int numDimensionsIn, double resolutionIn) {
+
+    list<region*> regionsSource;
+    regionsSource.push_back (&regionSourceIn);
+
+    return build (regionOperatingIn, obstaclesIn, regionsSource, numDimensionsIn, resolutionIn);
+}
+
+
+int NavigationField::build (region& regionOperatingIn, list<region*>& obstaclesIn, list<region*>& regionsSourceIn,
+                            int numDimensionsIn, double resolutionIn) {
+
+    if ( (numDimensionsIn <= 0) || (resolutionIn <= 0.0) )
+        return 0;
+
+    numDimensions = numDimensionsIn;
+    resolution = resolutionIn;
+
+    origin.resize (numDimensions);
+    numCells.resize (numDimensions);
+    strides.resize (numDimensions);
+
+    int numCellsTotal = 1;
+    for (int i = 0; i < numDimensions; i++) {
+        origin[i] = regionOperatingIn.center[i] - regionOperatingIn.size[i]/2.0;
+        numCells[i] = (int)ceil (regionOperatingIn.size[i]/resolution);
+        if (numCells[i] < 1)
+            numCells[i] = 1;
+        strides[i] = numCellsTotal;
+        numCellsTotal *= numCells[i];
+    }
+
+    // A path of neighbor moves along the unit vector u is longest relative to u when the
+    //   sorted components of u are proportional to sqrt(k) - sqrt(k-1)
+    stretch = 0.0;
+    for (int k = 1; k <= numDimensions; k++)
+        stretch += (sqrt ((double)k) - sqrt (k - 1.0))*(sqrt ((double)k) - sqrt (k - 1.0));
+    stretch = sqrt (stretch);
+
+    // Mark the cells that lie entirely inside an obstacle
+    vector<bool> blocked (numCellsTotal, false);
+    vector<int> cellMin (numDimensions), cellMax (numDimensions), cellCurr (numDimensions);
+    for (list<region*>::iterator iter = obstaclesIn.begin(); iter != obstaclesIn.end(); iter++) {
+
+        region *obstacleCurr = *iter;
+
+        bool empty = false;
+        for (int i = 0; i < numDimensions; i++) {
+            cellMin[i] = (int)ceil ((obstacleCurr->center[i] - obstacleCurr->size[i]/2.0 - origin[i])/resolution);
+            cellMax[i] = (int)floor ((obstacleCurr->center[i] + obstacleCurr->size[i]/2.0 - origin[i])/resolution) - 1;
+            if (cellMin[i] < 0)
+                cellMin[i] = 0;
+            if (cellMax[i] > numCells[i] - 1)
+                cellMax[i] = numCells[i] - 1;
+            if (cellMin[i] > cellMax[i])
+                empty = true;
+            cellCurr[i] = cellMin[i];
+        }
+        if (empty)
+            continue;
+
+        // Iterate over the block of cells like an odometer
+        while (true) {
+
+            int index = 0;
+            for (int i = 0; i < numDimensions; i++)
+                index += cellCurr[i]*strides[i];
+            blocked[index] = true;
+
+            int i = 0;
+            while ( (i < numDimensions) && (cellCurr[i] == cellMax[i]) ) {
+                cellCurr[i] = cellMin[i];
+                i++;
+            }
+            if (i == numDimensions)
+                break;
+            cellCurr[i]++;
+        }
+    }
+
+    // The unblocked cells that overlap a source region start at distance zero
+    typedef pair<double,int> entry_t;
+    priority_queue< entry_t, vector<entry_t>, greater<entry_t> > queue;
+
+    distance.assign (numCellsTotal, HUGE_VAL);
+    for (int k = 0; k < numCellsTotal; k++) {
+
+        if (blocked[k])
+            continue;
+
+        for (list<region*>::iterator iter = regionsSourceIn.begin(); iter != regionsSourceIn.end(); iter++) {
+
+            region *regionSourceCurr = *iter;
+
+            bool overlapping = true;
+            for (int i = 0; (i < numDimensions) && overlapping; i++) {
+                double lo = origin[i] + ((k/strides[i]) % numCells[i])*resolution;
+                if ( (lo > regionSourceCurr->center[i] + regionSourceCurr->size[i]/2.0)
+                     || (lo + resolution < regionSourceCurr->center[i] - regionSourceCurr->size[i]/2.0) )
+                    overlapping = false;
+            }
+
+            if (overlapping) {
+                distance[k] = 0.0;
+                queue.push (entry_t (0.0, k));
+                break;
+            }
+        }
+    }
+
+    // The offsets of the neighbors, each component in {-1, 0, 1}
+    int numNeighbors = 1;
+    for (int i = 0; i < numDimensions; i++)
+        numNeighbors *= 3;
+    vector<int> neighborSteps (numNeighbors*numDimensions);
+    vector<double> neighborLengths (numNeighbors);
+    for (int n = 0; n < numNeighbors; n++) {
+        int code = n;
+        int numChanged = 0;
+        for (int i = 0; i < numDimensions; i++) {
+            neighborSteps[n*numDimensions + i] = code % 3 - 1;
+            if (code % 3 != 1)
+                numChanged++;
+            code /= 3;
+        }
+        neighborLengths[n] = sqrt ((double)numChanged)*resolution;
+    }
+
+    while (!queue.empty()) {
+
+        entry_t entryCurr = queue.top ();
+        queue.pop ();
+
+        int k = entryCurr.second;
+        if (entryCurr.first > distance[k])
+            continue;
+
+        for (int n = 0; n < numNeighbors; n++) {
+
+            if (neighborLengths[n] == 0.0)
+                continue;
+
+            int kNext = k;
+            bool inside = true;
+            for (int i = 0; (i < numDimensions) && inside; i++) {
+                int step = neighborSteps[n*numDimensions + i];
+                int cellNext = (k/strides[i]) % numCells[i] + step;
+                if ( (cellNext < 0) || (cellNext >= numCells[i]) )
+                    inside = false;
+                kNext += step*strides[i];
+            }
+            if (!inside || blocked[kNext])
+                continue;
+
+            double distanceNext = distance[k] + neighborLengths[n];
+            if (distanceNext < distance[kNext]) {
+                distance[kNext] = distanceNext;
+                queue.push (entry_t (distanceNext, kNext));
+            }
+        }
+    }
+
+    return 1;
+}
+
+
+int NavigationField::getCellIndex (const double *stateIn) {
+
+    int index = 0;
+
+    for (int i = 0; i < numDimensions; i++) {
+        double cellCurr = floor ((stateIn[i] - origin[i])/resolution);
+        if ( !(cellCurr >= 0.0) || (cellCurr >= numCells[i]) )
+            return -1;
+        index += (int)cellCurr*strides[i];
+    }
+
+    return index;
+}
+
+
+int NavigationField::getCellCorner (int cellIndexIn, double *cornerOut) {
+
+    for (int i = 0; i < numDimensions; i++)
+        cornerOut[i] = origin[i] + ((cellIndexIn/strides[i]) % numCells[i])*resolution;
+
+    return 1;
+}
+
+
+double NavigationField::getDistance (const double *stateIn) {
+
+    int index = getCellIndex (stateIn);
+
+    if ( (index < 0) || distance.empty() )
+        return 0.0;
+
+    if (distance[index] == HUGE_VAL)
+        return HUGE_VAL;
+
+    double distanceOut = distance[index]/stretch - resolution*sqrt ((double)numDimensions);
+    if (distanceOut < 0.0)
+        distanceOut = 0.0;
+
+    return distanceOut;
+}
@@ -0,0 +1,146 @@
+/*!
+ * \file navigation_field.h
+ */
+
+#ifndef __RRTS_NAVIGATION_FIELD_H_
+#define __RRTS_NAVIGATION_FIELD_H_
+
+#include <list>
+#include <vector>
+
+#include "system_single_integrator.h"
+
+
+
+namespace SingleIntegrator {
+
+
+    /*!
+     * \brief Shortest path distances through the free space over a regular grid
+     *
+     * The operating region is divided into cubic cells of a given resolution.
+     * A cell is blocked if it lies entirely inside one obstacle, so that every
+     * free path only passes through unblocked cells. Dijkstra's algorithm
+     * computes the length of the shortest path between cell centers, moving
+     * to any of the 3^numDimensions - 1 neighboring cells, from the cells
+     * that overlap a source region to every cell. Cells that can not be
+     * reached have an infinite distance.
+     */
+    class NavigationField {
+
+        int numDimensions;
+        double resolution;
+
+        std::vector<double> origin;
+        std::vector<int> numCells;
+        std::vector<int> strides;
+
+        // Path distance of each cell center to the source, in world units
+        std::vector<double> distance;
+
+        // Ratio between the longest path of neighbor moves and the straight line it follows
+        double stretch;
+
+    public:
+
+        /*!
+         * \brief NavigationField constructor
+         *
+         * More elaborate description
+         */
+        NavigationField ();
+
+        /*!
+         * \brief NavigationField destructor
+         *
+         * More elaborate description
+         */
+        ~NavigationField ();
+
+        /*!
+         * \brief Rasterizes the obstacles and computes the distances to the source region
+         *
+         * The number of cells grows with the size of the operating region over
+         * the resolution to the power of the number of dimensions.
+         *
+         * \param regionOperatingIn The region covered by the grid
+         * \param obstaclesIn The list of obstacles
+         * \param regionSourceIn The region the distances are measured to
+         * \param numDimensionsIn Dimensionality of the grid
+         * \param resolutionIn The edge length of a cell
+         *
+         */
+        int build (region& regionOperatingIn, std::list<region*>& obstaclesIn, region& regionSourceIn,
+                   int numDimensionsIn, double resolutionIn);
+
+        /*!
+         * \brief Rasterizes the obstacles and computes the distances to the nearest source region
+         *
+         * More elaborate description
+         *
+         * \param regionOperatingIn The region covered by the grid
+         * \param obstaclesIn The list of obstacles
+         * \param regionsSourceIn The regions the distances are measured to
+         * \param numDimensionsIn Dimensionality of the grid
+         * \param resolutionIn The edge length of a cell
+         *
+         */
+        int build (region& regionOperatingIn, std::list<region*>& obstaclesIn, std::list<region*>& regionsSourceIn,
+                   int numDimensionsIn, double resolutionIn);
+
+        /*!
+         * \brief Returns the number of cells of the grid
+         *
+         * More elaborate description
+         */
+        int getNumCells () {return distance.size();}
+
+        /*!
+         * \brief Returns the index of the cell of the point, -1 outside the grid
+         *
+         * More elaborate description
+         *
+         * \param stateIn The point, an array of dimension numDimensions
+         *
+         */
+        int getCellIndex (const double *stateIn);
+
+        /*!
+         * \brief Returns the lower corner of the cell
+         *
+         * More elaborate description
+         *
+         * \param cellIndexIn The index of the cell
+         * \param cornerOut The corner, an array of dimension numDimensions
+         *
+         */
+        int getCellCorner (int cellIndexIn, double *cornerOut);
+
+        /*!
+         * \brief Returns the path distance between the center of the cell and the source
+         *
+         * More elaborate description
+         *
+         * \param cellIndexIn The index of the cell
+         *
+         */
+        double getCellDistance (int cellIndexIn) {return distance[cellIndexIn];}
+
+        /*!
+         * \brief Returns an estimate of the path distance between the point and the source
+         *
+         * The distance of the cell is divided by the stretch of the neighbor
+         * moves and reduced by the diagonal of a cell, which accounts for the
+         * position of the point and of the source inside their cells. Returns
+         * zero for points outside the grid and HUGE_VAL for cells that can not
+         * be reached.
+         *
+         * \param stateIn The point, an array of dimension numDimensions
+         *
+         */
+        double getDistance (const double *stateIn);
+    };
+}
+
+
+#endif
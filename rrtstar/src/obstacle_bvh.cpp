@@ -0,0 +1,253 @@
+#include "obstacle_bvh.h"
+#include <algorithm>
+#include <cmath>
+
+using namespace std;
+using namespace SingleIntegrator;
+
+#define BVH_LEAF_SIZE 8
+#define BVH_BRUTE_FORCE_SIZE 32
+#define BVH_STACK_SIZE 64
+
+
+// Slab test of the segment against the box, both closed
+static bool segmentIntersectsBox (const double *stateFromIn, const double *stateToIn,
+                                  const double *lo, const double *hi, int numDimensions) {
+
+    double tMin = 0.0;
+    double tMax = 1.0;
+
+    for (int i = 0; i < numDimensions; i++) {
+
+        double dist = stateToIn[i] - stateFromIn[i];
+
+        if (fabs(dist) < 1e-12) {
+            if ( (stateFromIn[i] < lo[i]) || (stateFromIn[i] > hi[i]) )
+                return false;
+            continue;
+        }
+
+        double t1 = (lo[i] - stateFromIn[i])/dist;
+        double t2 = (hi[i] - stateFromIn[i])/dist;
+        if (t1 > t2) {
+            double tmp = t1;
+            t1 = t2;
+            t2 = tmp;
+        }
+
+        if (t1 > tMin)
+            tMin = t1;
+        if (t2 < tMax)
+            tMax = t2;
+        if (tMin > tMax)
+            return false;
+    }
+
+    return true;
+}
+
+
+static bool pointInBox (const double *stateIn, const double *lo, const double *hi, int numDimensions) {
+
+    for (int i = 0; i < numDimensions; i++)
+        if ( (stateIn[i] < lo[i]) || (stateIn[i] > hi[i]) )
+            return false;
+
+    return true;
+}
+
+
+// Orders obstacle indices by the center of the obstacle along one axis
+struct compareObstacleCenters {
+
+    const vector<double> *lo;
+    const vector<double> *hi;
+    int numDimensions;
+    int axis;
+
+    bool operator() (int i, int j) const {
+        return ( (*lo)[i*numDimensions + axis] + (*hi)[i*numDimensions + axis] )
+             < ( (*lo)[j*numDimensions + axis] + (*hi)[j*numDimensions + axis] );
+    }
+};
+
+
+ObstacleBVH::ObstacleBVH () {
+
+    numDimensions = 0;
+    numObstacles = 0;
+}
+
+
+ObstacleBVH::~ObstacleBVH () {
+
+}
+
+
+int ObstacleBVH::buildNode (vector<int>& indices, int begin, int end, vector<double>& lo, vector<double>& hi) {
+
+    int nodeIndex = nodeLeft.size();
+
+    nodeLeft.push_back (-1);
+    nodeRight.push_back (-1);
+    nodeBegin.push_back (begin);
+    nodeEnd.push_back (end);
+
+    // Compute the bounding box of the node and the extent of the obstacle centers
+    vector<double> centerMin (numDimensions, HUGE_VAL);
+    vector<double> centerMax (numDimensions, -HUGE_VAL);
+    for (int i = 0; i < numDimensions; i++) {
+        nodeLo.push_back (HUGE_VAL);
+        nodeHi.push_back (-HUGE_VAL);
+    }
+    for (int k = begin; k < end; k++) {
+        for (int i = 0; i < numDimensions; i++) {
+            double loCurr = lo[indices[k]*numDimensions + i];
+            double hiCurr = hi[indices[k]*numDimensions + i];
+            if (loCurr < nodeLo[nodeIndex*numDimensions + i])
+                nodeLo[nodeIndex*numDimensions + i] = loCurr;
+            if (hiCurr > nodeHi[nodeIndex*numDimensions + i])
+                nodeHi[nodeIndex*numDimensions + i] = hiCurr;
+            double centerCurr = (loCurr + hiCurr)/2.0;
+            if (centerCurr < centerMin[i])
+                centerMin[i] = centerCurr;
+            if (centerCurr > centerMax[i])
+                centerMax[i] = centerCurr;
+        }
+    }
+
+    if ( (end - begin <= BVH_LEAF_SIZE) || (numObstacles <= BVH_BRUTE_FORCE_SIZE) )
+        return nodeIndex;
+
+    // Split at the median along the axis with the largest extent of the centers
+    int axis = 0;
+    for (int i = 1; i < numDimensions; i++)
+        if (centerMax[i] - centerMin[i] > centerMax[axis] - centerMin[axis])
+            axis = i;
+
+    compareObstacleCenters compare;
+    compare.lo = &lo;
+    compare.hi = &hi;
+    compare.numDimensions = numDimensions;
+    compare.axis = axis;
+
+    int middle = (begin + end)/2;
+    nth_element (indices.begin() + begin, indices.begin() + middle, indices.begin() + end, compare);
+
+    int left = buildNode (indices, begin, middle, lo, hi);
+    int right = buildNode (indices, middle, end, lo, hi);
+    nodeLeft[nodeIndex] = left;
+    nodeRight[nodeIndex] = right;
+
+    return nodeIndex;
+}
+
+
+int ObstacleBVH::build (list<region*>& obstaclesIn, int numDimensionsIn) {
+
+    numDimensions = numDimensionsIn;
+    numObstacles = obstaclesIn.size();
+
+    nodeLo.clear();
+    nodeHi.clear();
+    nodeLeft.clear();
+    nodeRight.clear();
+    nodeBegin.clear();
+    nodeEnd.clear();
+
+    // Copy the boxes of the obstacles
+    vector<double> lo (numObstacles*numDimensions);
+    vector<double> hi (numObstacles*numDimensions);
+    int k = 0;
+    for (list<region*>::iterator iter = obstaclesIn.begin(); iter != obstaclesIn.end(); iter++) {
+        region *obstacleCurr = *iter;
+        for (int i = 0; i < numDimensions; i++) {
+            lo[k*numDimensions + i] = obstacleCurr->center[i] - obstacleCurr->size[i]/2.0;
+            hi[k*numDimensions + i] = obstacleCurr->center[i] + obstacleCurr->size[i]/2.0;
+        }
+        k++;
+    }
+
+    if (numObstacles == 0) {
+        obstacleStore.setBoxes (lo, hi, numDimensions);
+        return 1;
+    }
+
+    vector<int> indices (numObstacles);
+    for (int i = 0; i < numObstacles; i++)
+        indices[i] = i;
+
+    buildNode (indices, 0, numObstacles, lo, hi);
+
+    // Store the boxes in the order of the leaves
+    vector<double> loSorted (numObstacles*numDimensions);
+    vector<double> hiSorted (numObstacles*numDimensions);
+    for (int k = 0; k < numObstacles; k++) {
+        for (int i = 0; i < numDimensions; i++) {
+            loSorted[k*numDimensions + i] = lo[indices[k]*numDimensions + i];
+            hiSorted[k*numDimensions + i] = hi[indices[k]*numDimensions + i];
+        }
+    }
+
+    return obstacleStore.setBoxes (loSorted, hiSorted, numDimensions);
+}
+
+
+bool ObstacleBVH::isInCollision (const double *stateIn) {
+
+    if (numObstacles == 0)
+        return false;
+
+    int stack[BVH_STACK_SIZE];
+    int stackSize = 0;
+    stack[stackSize++] = 0;
+
+    while (stackSize > 0) {
+
+        int nodeCurr = stack[--stackSize];
+
+        if (!pointInBox (stateIn, &nodeLo[nodeCurr*numDimensions], &nodeHi[nodeCurr*numDimensions], numDimensions))
+            continue;
+
+        if (nodeLeft[nodeCurr] < 0) {
+            if (obstacleStore.isInCollision (stateIn, nodeBegin[nodeCurr], nodeEnd[nodeCurr]))
+                return true;
+            continue;
+        }
+
+        stack[stackSize++] = nodeLeft[nodeCurr];
+        stack[stackSize++] = nodeRight[nodeCurr];
+    }
+
+    return false;
+}
+
+
+bool ObstacleBVH::isInCollision (const double *stateFromIn, const double *stateToIn) {
+
+    if (numObstacles == 0)
+        return false;
+
+    int stack[BVH_STACK_SIZE];
+    int stackSize = 0;
+    stack[stackSize++] = 0;
+
+    while (stackSize > 0) {
+
+        int nodeCurr = stack[--stackSize];
+
+        if (!segmentIntersectsBox (stateFromIn, stateToIn, &nodeLo[nodeCurr*numDimensions], &nodeHi[nodeCurr*numDimensions], numDimensions))
+            continue;
+
+        if (nodeLeft[nodeCurr] < 0) {
+            if (obstacleStore.isInCollision (stateFromIn, stateToIn, nodeBegin[nodeCurr], nodeEnd[nodeCurr]))
+                return true;
+            continue;
+        }
+
+        stack[stackSize++] = nodeLeft[nodeCurr];
+        stack[stackSize++] = nodeRight[nodeCurr];
+    }
+
+    return false;
+}
@@ -0,0 +1,112 @@
+/*!
+ * \file obstacle_bvh.h
+ */
+
+#ifndef __RRTS_OBSTACLE_BVH_H_
+#define __RRTS_OBSTACLE_BVH_H_
+
+#include <list>
+#include <vector>
+
+#include "system_single_integrator.h"
+#include "obstacle_store.h"
+
+
+
+namespace SingleIntegrator {
+
+
+    /*!
+     * \brief Bounding volume hierarchy over axis aligned obstacle boxes
+     *
+     * The hierarchy is built top-down by splitting the obstacles at the median
+     * of their centers along the longest axis. Point and segment queries visit
+     * only the nodes whose bounding box contains the point or intersects the
+     * segment, which takes logarithmic time in the number of obstacles for
+     * sparse queries. The obstacles of a leaf are tested together with
+     * ObstacleStore, and small obstacle sets are kept in a single leaf that
+     * is scanned by brute force.
+     */
+    class ObstacleBVH {
+
+        int numDimensions;
+        int numObstacles;
+
+        // Obstacle boxes in the order of the leaves
+        ObstacleStore obstacleStore;
+
+        // Node bounding boxes, numDimensions values per node
+        std::vector<double> nodeLo;
+        std::vector<double> nodeHi;
+
+        // Children of the internal nodes, -1 for the leaves
+        std::vector<int> nodeLeft;
+        std::vector<int> nodeRight;
+
+        // Range of obstacles in the leaves
+        std::vector<int> nodeBegin;
+        std::vector<int> nodeEnd;
+
+        int buildNode (std::vector<int>& indices, int begin, int end,
+                       std::vector<double>& lo, std::vector<double>& hi);
+
+    public:
+
+        /*!
+         * \brief ObstacleBVH constructor
+         *
+         * More elaborate description
+         */
+        ObstacleBVH ();
+
+        /*!
+         * \brief ObstacleBVH destructor
+         *
+         * More elaborate description
+         */
+        ~ObstacleBVH ();
+
+        /*!
+         * \brief Builds the hierarchy over the given obstacles
+         *
+         * The boxes are copied, so the hierarchy has to be rebuilt when an
+         * obstacle changes.
+         *
+         * \param obstaclesIn The list of obstacles
+         * \param numDimensionsIn Dimensionality of the obstacles
+         *
+         */
+        int build (std::list<region*>& obstaclesIn, int numDimensionsIn);
+
+        /*!
+         * \brief Returns the number of obstacles in the hierarchy
+         *
+         * More elaborate description
+         */
+        int getNumObstacles () {return numObstacles;}
+
+        /*!
+         * \brief Returns true if the point lies inside an obstacle
+         *
+         * More elaborate description
+         *
+         * \param stateIn The point, an array of dimension numDimensions
+         *
+         */
+        bool isInCollision (const double *stateIn);
+
+        /*!
+         * \brief Returns true if the segment between two points intersects an obstacle
+         *
+         * More elaborate description
+         *
+         * \param stateFromIn Start of the segment
+         * \param stateToIn End of the segment
+         *
+         */
+        bool isInCollision (const double *stateFromIn, const double *stateToIn);
+    };
+}
+
+
+#endif
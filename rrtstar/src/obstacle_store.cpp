@@ -0,0 +1,161 @@
+#include "obstacle_store.h"
+#include <cmath>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+using namespace std;
+using namespace SingleIntegrator;
+
+#define STORE_PARALLEL_DIST 1e-12
+
+
+ObstacleStore::ObstacleStore () {
+
+    numDimensions = 0;
+    numObstacles = 0;
+}
+
+
+ObstacleStore::~ObstacleStore () {
+
+}
+
+
+int ObstacleStore::setBoxes (const vector<double>& loIn, const vector<double>& hiIn, int numDimensionsIn) {
+
+    if ( (numDimensionsIn <= 0) || (loIn.size() != hiIn.size()) )
+        return 0;
+
+    numDimensions = numDimensionsIn;
+    numObstacles = loIn.size()/numDimensions;
+
+    lo.resize (numObstacles*numDimensions);
+    hi.resize (numObstacles*numDimensions);
+    for (int k = 0; k < numObstacles; k++) {
+        for (int i = 0; i < numDimensions; i++) {
+            lo[i*numObstacles + k] = loIn[k*numDimensions + i];
+            hi[i*numObstacles + k] = hiIn[k*numDimensions + i];
+        }
+    }
+
+    return 1;
+}
+
+
+bool ObstacleStore::isInCollision (const double *stateIn, int beginIn, int endIn) {
+
+    int k = beginIn;
+
+#ifdef __AVX2__
+    for (; k + 4 <= endIn; k += 4) {
+
+        __m256d inside = _mm256_castsi256_pd (_mm256_set1_epi64x (-1));
+
+        for (int i = 0; i < numDimensions; i++) {
+            __m256d x = _mm256_set1_pd (stateIn[i]);
+            __m256d loCurr = _mm256_loadu_pd (&lo[i*numObstacles + k]);
+            __m256d hiCurr = _mm256_loadu_pd (&hi[i*numObstacles + k]);
+            inside = _mm256_and_pd (inside, _mm256_cmp_pd (loCurr, x, _CMP_LE_OQ));
+            inside = _mm256_and_pd (inside, _mm256_cmp_pd (x, hiCurr, _CMP_LE_OQ));
+        }
+
+        if (_mm256_movemask_pd (inside))
+            return true;
+    }
+#endif
+
+    for (; k < endIn; k++) {
+
+        bool inside = true;
+        for (int i = 0; (i < numDimensions) && inside; i++)
+            if ( (stateIn[i] < lo[i*numObstacles + k]) || (stateIn[i] > hi[i*numObstacles + k]) )
+                inside = false;
+
+        if (inside)
+            return true;
+    }
+
+    return false;
+}
+
+
+bool ObstacleStore::isInCollision (const double *stateFromIn, const double *stateToIn, int beginIn, int endIn) {
+
+    int k = beginIn;
+
+#ifdef __AVX2__
+    for (; k + 4 <= endIn; k += 4) {
+
+        // Slab test on four boxes, the segment hits a box if its interval stays non-empty
+        __m256d tMin = _mm256_setzero_pd ();
+        __m256d tMax = _mm256_set1_pd (1.0);
+
+        for (int i = 0; i < numDimensions; i++) {
+
+            double dist = stateToIn[i] - stateFromIn[i];
+            __m256d x = _mm256_set1_pd (stateFromIn[i]);
+            __m256d loCurr = _mm256_loadu_pd (&lo[i*numObstacles + k]);
+            __m256d hiCurr = _mm256_loadu_pd (&hi[i*numObstacles + k]);
+
+            if (fabs(dist) < STORE_PARALLEL_DIST) {
+                // Parallel to the slab: empty the interval of the boxes that do not contain the start
+                __m256d inside = _mm256_and_pd (_mm256_cmp_pd (loCurr, x, _CMP_LE_OQ),
+                                                _mm256_cmp_pd (x, hiCurr, _CMP_LE_OQ));
+                tMax = _mm256_blendv_pd (_mm256_set1_pd (-1.0), tMax, inside);
+            }
+            else {
+                __m256d distInv = _mm256_set1_pd (1.0/dist);
+                __m256d t1 = _mm256_mul_pd (_mm256_sub_pd (loCurr, x), distInv);
+                __m256d t2 = _mm256_mul_pd (_mm256_sub_pd (hiCurr, x), distInv);
+                tMin = _mm256_max_pd (tMin, _mm256_min_pd (t1, t2));
+                tMax = _mm256_min_pd (tMax, _mm256_max_pd (t1, t2));
+            }
+
+            if (_mm256_movemask_pd (_mm256_cmp_pd (tMin, tMax, _CMP_LE_OQ)) == 0)
+                break;
+        }
+
+        if (_mm256_movemask_pd (_mm256_cmp_pd (tMin, tMax, _CMP_LE_OQ)))
+            return true;
+    }
+#endif
+
+    for (; k < endIn; k++) {
+
+        double tMin = 0.0;
+        double tMax = 1.0;
+
+        for (int i = 0; (i < numDimensions) && (tMin <= tMax); i++) {
+
+            double dist = stateToIn[i] - stateFromIn[i];
+            double loCurr = lo[i*numObstacles + k];
+            double hiCurr = hi[i*numObstacles + k];
+
+            if (fabs(dist) < STORE_PARALLEL_DIST) {
+                if ( (stateFromIn[i] < loCurr) || (stateFromIn[i] > hiCurr) )
+                    tMax = -1.0;
+                continue;
+            }
+
+            double t1 = (loCurr - stateFromIn[i])/dist;
+            double t2 = (hiCurr - stateFromIn[i])/dist;
+            if (t1 > t2) {
+                double tmp = t1;
+                t1 = t2;
+                t2 = tmp;
+            }
+
+            if (t1 > tMin)
+                tMin = t1;
+            if (t2 < tMax)
+                tMax = t2;
+        }
+
+        if (tMin <= tMax)
+            return true;
+    }
+
+    return false;
+}
@@ -0,0 +1,95 @@
+/*!
+ * \file obstacle_store.h
+ */
+
+#ifndef __RRTS_OBSTACLE_STORE_H_
+#define __RRTS_OBSTACLE_STORE_H_
+
+#include <vector>
+
+
+
+namespace SingleIntegrator {
+
+
+    /*!
+     * \brief Structure of arrays storage of axis aligned obstacle boxes
+     *
+     * The lower and upper corners of the boxes are stored one dimension after
+     * the other, so that consecutive boxes are contiguous in memory for each
+     * dimension. When compiled with AVX2 support (__AVX2__), the queries test
+     * four boxes per instruction; otherwise a scalar loop is used.
+     */
+    class ObstacleStore {
+
+        int numDimensions;
+        int numObstacles;
+
+        // Box corners, lo[i*numObstacles + k] is the lower bound of box k in dimension i
+        std::vector<double> lo;
+        std::vector<double> hi;
+
+    public:
+
+        /*!
+         * \brief ObstacleStore constructor
+         *
+         * More elaborate description
+         */
+        ObstacleStore ();
+
+        /*!
+         * \brief ObstacleStore destructor
+         *
+         * More elaborate description
+         */
+        ~ObstacleStore ();
+
+        /*!
+         * \brief Replaces the stored boxes
+         *
+         * The corners are given box after box, with numDimensionsIn values per box.
+         *
+         * \param loIn Lower corners of the boxes
+         * \param hiIn Upper corners of the boxes
+         * \param numDimensionsIn Dimensionality of the boxes
+         *
+         */
+        int setBoxes (const std::vector<double>& loIn, const std::vector<double>& hiIn, int numDimensionsIn);
+
+        /*!
+         * \brief Returns the number of stored boxes
+         *
+         * More elaborate description
+         */
+        int getNumObstacles () {return numObstacles;}
+
+        /*!
+         * \brief Returns true if the point lies inside one of the boxes in [beginIn, endIn)
+         *
+         * More elaborate description
+         *
+         * \param stateIn The point, an array of dimension numDimensions
+         * \param beginIn Index of the first box to be tested
+         * \param endIn One past the index of the last box to be tested
+         *
+         */
+        bool isInCollision (const double *stateIn, int beginIn, int endIn);
+
+        /*!
+         * \brief Returns true if the segment intersects one of the boxes in [beginIn, endIn)
+         *
+         * More elaborate description
+         *
+         * \param stateFromIn Start of the segment
+         * \param stateToIn End of the segment
+         * \param beginIn Index of the first box to be tested
+         * \param endIn One past the index of the last box to be tested
+         *
+         */
+        bool isInCollision (const double *stateFromIn, const double *stateToIn, int beginIn, int endIn);
+    };
+}
+
+
+#endif
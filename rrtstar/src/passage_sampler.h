@@ -0,0 +1,100 @@
+/*!
+ * \file passage_sampler.h
+ */
+
+#ifndef __RRTS_PASSAGE_SAMPLER_H_
+#define __RRTS_PASSAGE_SAMPLER_H_
+
+#include "sampler.h"
+
+
+
+namespace RRTstar {
+
+
+    /*!
+     * \brief Gaussian sampling near the boundary of the obstacles
+     *
+     * Pairs the given point with a second point at a normally distributed
+     * offset. If exactly one of the two points is blocked, the free one is
+     * returned in stateInOut. Otherwise the sample is rejected.
+     *
+     * \param checkerIn The object that provides the point checker
+     * \param isBlockedIn The point checker, returns true if the point is in collision or outside the operating region
+     * \param samplerIn The sampler that draws the offset
+     * \param stateInOut A uniformly distributed point, replaced by the sample
+     * \param numDimensionsIn Dimension of the points
+     * \param deviationIn Standard deviation of the offset along each dimension
+     *
+     * Returns 1 if the sample is accepted, 0 otherwise.
+     */
+    template<class Checker>
+    int sampleGaussian (Checker& checkerIn, bool (Checker::*isBlockedIn)(double*), Sampler& samplerIn,
+                        double *stateInOut, int numDimensionsIn, double deviationIn) {
+
+        double *stateOther = new double[numDimensionsIn];
+        for (int i = 0; i < numDimensionsIn; i++)
+            stateOther[i] = stateInOut[i] + deviationIn*samplerIn.sampleNormal ();
+
+        bool blocked = (checkerIn.*isBlockedIn)(stateInOut);
+        bool blockedOther = (checkerIn.*isBlockedIn)(stateOther);
+
+        if (blocked && !blockedOther)
+            for (int i = 0; i < numDimensionsIn; i++)
+                stateInOut[i] = stateOther[i];
+
+        delete [] stateOther;
+
+        return (blocked != blockedOther) ? 1 : 0;
+    }
+
+
+    /*!
+     * \brief Bridge test sampling in narrow passages
+     *
+     * Pairs the given point with a second point at a normally distributed
+     * offset. If both points are blocked and their midpoint is free, the
+     * midpoint is returned in stateInOut. Otherwise the sample is rejected.
+     * The given point is checked first, so most rejections cost one check.
+     *
+     * \param checkerIn The object that provides the point checker
+     * \param isBlockedIn The point checker, returns true if the point is in collision or outside the operating region
+     * \param samplerIn The sampler that draws the offset
+     * \param stateInOut A uniformly distributed point, replaced by the sample
+     * \param numDimensionsIn Dimension of the points
+     * \param deviationIn Standard deviation of the offset along each dimension
+     *
+     * Returns 1 if the sample is accepted, 0 otherwise.
+     */
+    template<class Checker>
+    int sampleBridge (Checker& checkerIn, bool (Checker::*isBlockedIn)(double*), Sampler& samplerIn,
+                      double *stateInOut, int numDimensionsIn, double deviationIn) {
+
+        if (!(checkerIn.*isBlockedIn)(stateInOut))
+            return 0;
+
+        double *stateOther = new double[numDimensionsIn];
+        for (int i = 0; i < numDimensionsIn; i++)
+            stateOther[i] = stateInOut[i] + deviationIn*samplerIn.sampleNormal ();
+
+        int accepted = 0;
+        if ((checkerIn.*isBlockedIn)(stateOther)) {
+
+            for (int i = 0; i < numDimensionsIn; i++)
+                stateOther[i] = (stateInOut[i] + stateOther[i])/2.0;
+
+            if (!(checkerIn.*isBlockedIn)(stateOther)) {
+                for (int i = 0; i < numDimensionsIn; i++)
+                    stateInOut[i] = stateOther[i];
+                accepted = 1;
+            }
+        }
+
+        delete [] stateOther;
+
+        return accepted;
+    }
+}
+
+
+#endif
@@ -0,0 +1,221 @@
+/*!
+ * \file path_optimizer.h
+ */
+
+#ifndef __RRTS_PATH_OPTIMIZER_H_
+#define __RRTS_PATH_OPTIMIZER_H_
+
+#include <chrono>
+#include <list>
+#include <vector>
+
+#include "rrts.h"
+#include "sampler.h"
+
+
+
+namespace RRTstar {
+
+
+    enum {
+        SHORTCUT_GREEDY,
+        SHORTCUT_RANDOM
+    };
+
+
+    /*!
+     * \brief Shortcutting and smoothing of a path found by the planner
+     *
+     * The path is copied from the vertices between the root and a given
+     * vertex of the tree, usually the best vertex of the planner, and then
+     * shortened in place without changing the tree. Shortcutting replaces
+     * the states between two states of the path by the direct trajectory
+     * between them, if System::extendTo connects them exactly without
+     * collision and the cost decreases. Greedy shortcutting connects each
+     * state to the farthest state it can reach. Random shortcutting tries
+     * pairs of states drawn at random. Smoothing then moves each interior
+     * state halfway towards the midpoint of its neighbors, averaging the
+     * coordinates of the states, and keeps the moves that lower the cost.
+     * Both stages stop when the time budget runs out.
+     */
+    template<class State, class Trajectory, class System>
+    class PathOptimizer {
+
+        System *system;
+
+        std::vector<State> path;
+
+        int shortcutMode;
+        int maxShortcutAttempts;
+        int numSmoothingIterations;
+        double timeBudget;
+
+        Sampler sampler;
+
+        double initialCost;
+        int numShortcuts;
+        int numSmoothingMoves;
+
+        std::chrono::steady_clock::time_point timeStart;
+        bool isOutOfTime ();
+
+        int connect (State& stateFromIn, State& stateToIn, double& costOut);
+        int shortcut (int indexFromIn, int indexToIn);
+
+    public:
+
+        /*!
+         * \brief PathOptimizer constructor
+         *
+         * More elaborate description
+         */
+        PathOptimizer ();
+
+        /*!
+         * \brief PathOptimizer destructor
+         *
+         * More elaborate description
+         */
+        ~PathOptimizer ();
+
+        /*!
+         * \brief Sets the system that checks and connects the states
+         *
+         * More elaborate description
+         *
+         * \param systemIn The dynamical system
+         *
+         */
+        int setSystem (System& systemIn);
+
+        /*!
+         * \brief Copies the path from the root of the tree to the given vertex
+         *
+         * More elaborate description
+         *
+         * \param vertexEndIn The last vertex of the path
+         *
+         */
+        int setPath (Vertex<State,Trajectory,System>& vertexEndIn);
+
+        /*!
+         * \brief Sets the shortcutting mode, SHORTCUT_GREEDY or SHORTCUT_RANDOM
+         *
+         * More elaborate description
+         *
+         * \param shortcutModeIn The shortcutting mode
+         *
+         */
+        int setShortcutMode (int shortcutModeIn);
+
+        /*!
+         * \brief Sets the number of pairs of states tried by random shortcutting
+         *
+         * More elaborate description
+         *
+         * \param maxShortcutAttemptsIn The number of pairs
+         *
+         */
+        int setMaxShortcutAttempts (int maxShortcutAttemptsIn);
+
+        /*!
+         * \brief Sets the number of smoothing passes over the path, zero disables smoothing
+         *
+         * More elaborate description
+         *
+         * \param numSmoothingIterationsIn The number of passes
+         *
+         */
+        int setNumSmoothingIterations (int numSmoothingIterationsIn);
+
+        /*!
+         * \brief Sets the time budget of optimize, in seconds
+         *
+         * More elaborate description
+         *
+         * \param timeBudgetIn The time budget, HUGE_VAL for no limit
+         *
+         */
+        int setTimeBudget (double timeBudgetIn);
+
+        /*!
+         * \brief Returns the sampler that draws the pairs of random shortcutting
+         *
+         * More elaborate description
+         */
+        Sampler& getSampler () {return sampler;}
+
+        /*!
+         * \brief Shortcuts and then smooths the path within the time budget
+         *
+         * More elaborate description
+         */
+        int optimize ();
+
+        /*!
+         * \brief Returns the cost of the path, as evaluated by System::evaluateExtensionCost
+         *
+         * More elaborate description
+         */
+        double getCost ();
+
+        /*!
+         * \brief Returns the cost of the path given to setPath
+         *
+         * More elaborate description
+         */
+        double getInitialCost () {return initialCost;}
+
+        /*!
+         * \brief Returns the difference between the initial and the current cost
+         *
+         * More elaborate description
+         */
+        double getCostReduction () {return initialCost - getCost ();}
+
+        /*!
+         * \brief Returns the number of shortcuts taken by the last call to optimize
+         *
+         * More elaborate description
+         */
+        int getNumShortcuts () {return numShortcuts;}
+
+        /*!
+         * \brief Returns the number of smoothing moves taken by the last call to optimize
+         *
+         * More elaborate description
+         */
+        int getNumSmoothingMoves () {return numSmoothingMoves;}
+
+        /*!
+         * \brief Returns the number of states of the path
+         *
+         * More elaborate description
+         */
+        int getNumStates () {return path.size();}
+
+        /*!
+         * \brief Returns a reference to a state of the path
+         *
+         * More elaborate description
+         *
+         * \param indexIn The index of the state, zero at the root
+         *
+         */
+        State& getState (int indexIn) {return path[indexIn];}
+
+        /*!
+         * \brief Returns the path as a list of double arrays
+         *
+         * The trajectories between consecutive states are drawn with
+         * System::getTrajectory, as in Planner::getBestTrajectory.
+         *
+         * \param trajectoryOut The list of double arrays of dimension system->getNumDimensions()
+         *
+         */
+        int getTrajectory (std::list<double*>& trajectoryOut);
+    };
+}
+
+
+#endif
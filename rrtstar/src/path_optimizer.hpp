@@ -0,0 +1,304 @@
+/*!
+ * \file path_optimizer.hpp
+ */
+
+#ifndef __RRTS_PATH_OPTIMIZER_HPP_
+#define __RRTS_PATH_OPTIMIZER_HPP_
+
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+
+#include "path_optimizer.h"
+
+
+
+template<class State, class Trajectory, class System>
+RRTstar::PathOptimizer<State, Trajectory, System>
+::PathOptimizer () {
+
+    system = NULL;
+
+    shortcutMode = SHORTCUT_GREEDY;
+    maxShortcutAttempts = 1000;
+    numSmoothingIterations = 0;
+    timeBudget = HUGE_VAL;
+
+    initialCost = 0.0;
+    numShortcuts = 0;
+    numSmoothingMoves = 0;
+}
+
+
+template<class State, class Trajectory, class System>
+RRTstar::PathOptimizer<State, Trajectory, System>
+::~PathOptimizer () {
+
+}
+
+
+template<class State, class Trajectory, class System>
+int
+RRTstar::PathOptimizer<State, Trajectory, System>
+::setSystem (System& systemIn) {
+
+    system = &systemIn;
+
+    return 1;
+}
+
+
+template<class State, class Trajectory, class System>
+int
+RRTstar::PathOptimizer<State, Trajectory, System>
+::setPath (Vertex<State,Trajectory,System>& vertexEndIn) {
+
+    if (system == NULL)
+        return 0;
+
+    // Collect the states from the given vertex to the root
+    path.clear ();
+    Vertex<State,Trajectory,System>* vertexCurr = &vertexEndIn;
+    while (vertexCurr) {
+        path.push_back (vertexCurr->getState());
+        vertexCurr = vertexCurr->parent;
+    }
+    std::reverse (path.begin(), path.end());
+
+    initialCost = getCost ();
+    numShortcuts = 0;
+    numSmoothingMoves = 0;
+
+    return 1;
+}
+
+
+template<class State, class Trajectory, class System>
+int
+RRTstar::PathOptimizer<State, Trajectory, System>
+::setShortcutMode (int shortcutModeIn) {
+
+    if ( (shortcutModeIn != SHORTCUT_GREEDY) && (shortcutModeIn != SHORTCUT_RANDOM) )
+        return 0;
+
+    shortcutMode = shortcutModeIn;
+
+    return 1;
+}
+
+
+template<class State, class Trajectory, class System>
+int
+RRTstar::PathOptimizer<State, Trajectory, System>
+::setMaxShortcutAttempts (int maxShortcutAttemptsIn) {
+
+    if (maxShortcutAttemptsIn < 0)
+        return 0;
+
+    maxShortcutAttempts = maxShortcutAttemptsIn;
+
+    return 1;
+}
+
+
+template<class State, class Trajectory, class System>
+int
+RRTstar::PathOptimizer<State, Trajectory, System>
+::setNumSmoothingIterations (int numSmoothingIterationsIn) {
+
+    if (numSmoothingIterationsIn < 0)
+        return 0;
+
+    numSmoothingIterations = numSmoothingIterationsIn;
+
+    return 1;
+}
+
+
+template<class State, class Trajectory, class System>
+int
+RRTstar::PathOptimizer<State, Trajectory, System>
+::setTimeBudget (double timeBudgetIn) {
+
+    if (timeBudgetIn < 0.0)
+        return 0;
+
+    timeBudget = timeBudgetIn;
+
+    return 1;
+}
+
+
+template<class State, class Trajectory, class System>
+bool
+RRTstar::PathOptimizer<State, Trajectory, System>
+::isOutOfTime () {
+
+    if (timeBudget == HUGE_VAL)
+        return false;
+
+    double timeElapsed = std::chrono::duration<double> (std::chrono::steady_clock::now () - timeStart).count ();
+
+    return (timeElapsed > timeBudget);
+}
+
+
+template<class State, class Trajectory, class System>
+int
+RRTstar::PathOptimizer<State, Trajectory, System>
+::connect (State& stateFromIn, State& stateToIn, double& costOut) {
+
+    // Check the trajectory for collision with the obstacles
+    Trajectory trajectory;
+    bool exactConnection = false;
+    if ( (system->extendTo (stateFromIn, stateToIn, trajectory, exactConnection) <= 0) || (exactConnection == false) )
+        return 0;
+
+    costOut = system->evaluateExtensionCost (stateFromIn, stateToIn, exactConnection);
+
+    return 1;
+}
+
+
+template<class State, class Trajectory, class System>
+int
+RRTstar::PathOptimizer<State, Trajectory, System>
+::shortcut (int indexFromIn, int indexToIn) {
+
+    // Cost of the path between the two states
+    double costPath = 0.0;
+    for (int k = indexFromIn; k < indexToIn; k++) {
+        bool exactConnection = false;
+        costPath += system->evaluateExtensionCost (path[k], path[k+1], exactConnection);
+    }
+
+    double costShortcut = 0.0;
+    if ( (connect (path[indexFromIn], path[indexToIn], costShortcut) <= 0) || (costShortcut >= costPath - 0.001) )
+        return 0;
+
+    path.erase (path.begin() + indexFromIn + 1, path.begin() + indexToIn);
+
+    return 1;
+}
+
+
+template<class State, class Trajectory, class System>
+int
+RRTstar::PathOptimizer<State, Trajectory, System>
+::optimize () {
+
+    if ( (system == NULL) || path.empty() )
+        return 0;
+
+    timeStart = std::chrono::steady_clock::now ();
+
+    numShortcuts = 0;
+    numSmoothingMoves = 0;
+
+    // 1. Shortcutting
+    if (shortcutMode == SHORTCUT_GREEDY) {
+
+        // Connect each state to the farthest state that it reaches at a lower cost
+        for (int i = 0; (i < (int)path.size() - 2) && !isOutOfTime (); i++) {
+            for (int j = path.size() - 1; (j > i + 1) && !isOutOfTime (); j--) {
+                if (shortcut (i, j) > 0) {
+                    numShortcuts++;
+                    break;
+                }
+            }
+        }
+    }
+    else {
+
+        for (int attempt = 0; (attempt < maxShortcutAttempts) && (path.size() > 2) && !isOutOfTime (); attempt++) {
+
+            int numStates = path.size();
+            int i = (int)(sampler.sampleUniform () * numStates);
+            int j = (int)(sampler.sampleUniform () * numStates);
+            if (i > j)
+                std::swap (i, j);
+            if (j - i < 2)
+                continue;
+
+            if (shortcut (i, j) > 0)
+                numShortcuts++;
+        }
+    }
+
+    // 2. Smoothing
+    int numDimensions = system->getNumDimensions ();
+    for (int iteration = 0; (iteration < numSmoothingIterations) && !isOutOfTime (); iteration++) {
+
+        for (int k = 1; (k < (int)path.size() - 1) && !isOutOfTime (); k++) {
+
+            // Move the state halfway towards the midpoint of its neighbors
+            State stateNew (path[k]);
+            for (int i = 0; i < numDimensions; i++)
+                stateNew[i] = (path[k][i] + (path[k-1][i] + path[k+1][i])/2.0)/2.0;
+
+            bool exactConnection = false;
+            double costCurr = system->evaluateExtensionCost (path[k-1], path[k], exactConnection)
+                + system->evaluateExtensionCost (path[k], path[k+1], exactConnection);
+            double costIn = system->evaluateExtensionCost (path[k-1], stateNew, exactConnection);
+            double costOut = system->evaluateExtensionCost (stateNew, path[k+1], exactConnection);
+            if (costIn + costOut >= costCurr - 0.001)
+                continue;
+
+            // Check the two new trajectories only if the move lowers the cost
+            if ( (connect (path[k-1], stateNew, costIn) <= 0) || (connect (stateNew, path[k+1], costOut) <= 0) )
+                continue;
+
+            path[k] = stateNew;
+            numSmoothingMoves++;
+        }
+    }
+
+    return 1;
+}
+
+
+template<class State, class Trajectory, class System>
+double
+RRTstar::PathOptimizer<State, Trajectory, System>
+::getCost () {
+
+    double costTotal = 0.0;
+
+    for (int k = 0; k < (int)path.size() - 1; k++) {
+        bool exactConnection = false;
+        costTotal += system->evaluateExtensionCost (path[k], path[k+1], exactConnection);
+    }
+
+    return costTotal;
+}
+
+
+template<class State, class Trajectory, class System>
+int
+RRTstar::PathOptimizer<State, Trajectory, System>
+::getTrajectory (std::list<double*>& trajectoryOut) {
+
+    if (path.empty())
+        return 0;
+
+    int numDimensions = system->getNumDimensions ();
+
+    double *stateArrCurr = new double[numDimensions];
+    for (int i = 0; i < numDimensions; i++)
+        stateArrCurr[i] = path[0][i];
+    trajectoryOut.push_back (stateArrCurr);
+
+    for (int k = 0; k < (int)path.size() - 1; k++) {
+
+        std::list<double*> trajectory;
+        system->getTrajectory (path[k], path[k+1], trajectory);
+
+        trajectoryOut.splice (trajectoryOut.end(), trajectory);
+    }
+
+    return 1;
+}
+
+
+#endif
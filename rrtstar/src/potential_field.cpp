@@ -0,0 +1,191 @@
+#include "potential_field.h"
+#include <cmath>
+
+using namespace std;
+using namespace SingleIntegrator;
+
+
+#define POTENTIAL_FIELD_MAX_DIMENSIONS 10
+
+
+PotentialField::PotentialField () {
+
+    numDimensions = 0;
+    resolution = 1.0;
+
+    distanceField = &distanceFieldOwn;
+}
+
+
+PotentialField::~PotentialField () {
+
+}
+
+
+int PotentialField::build (region& regionOperatingIn, list<region*>& regionsGoalIn, list<region*>& obstaclesIn, int numDimensionsIn,
+                           double resolutionIn, double influenceDistanceIn, double repulsiveGainIn,
+                           DistanceField *distanceFieldIn) {
+
+    if ( (numDimensionsIn <= 0) || (numDimensionsIn > POTENTIAL_FIELD_MAX_DIMENSIONS) 
+         || (resolutionIn <= 0.0) || (influenceDistanceIn <= 0.0) || (repulsiveGainIn < 0.0) )
+        return 0;
+
+    if ( distanceFieldIn && (distanceFieldIn->getResolution () == resolutionIn) )
+        distanceField = distanceFieldIn;
+    else {
+        distanceField = &distanceFieldOwn;
+        if (distanceField->build (regionOperatingIn, obstaclesIn, numDimensionsIn, resolutionIn) <= 0)
+            return 0;
+    }
+
+    numDimensions = numDimensionsIn;
+    resolution = resolutionIn;
+
+    origin.resize (numDimensions);
+    numCells.resize (numDimensions);
+    strides.resize (numDimensions);
+
+    int numCellsTotal = 1;
+    for (int i = 0; i < numDimensions; i++) {
+        origin[i] = regionOperatingIn.center[i] - regionOperatingIn.size[i]/2.0;
+        numCells[i] = (int)ceil (regionOperatingIn.size[i]/resolution);
+        if (numCells[i] < 1)
+            numCells[i] = 1;
+        strides[i] = numCellsTotal;
+        numCellsTotal *= numCells[i];
+    }
+
+    // Potential at the cell centers
+    potential.resize (numCellsTotal);
+    vector<double> stateCenter (numDimensions);
+    for (int k = 0; k < numCellsTotal; k++) {
+
+        for (int i = 0; i < numDimensions; i++)
+            stateCenter[i] = origin[i] + ((k/strides[i]) % numCells[i] + 0.5)*resolution;
+
+        // Squared distance to the nearest goal region
+        double distGoal = HUGE_VAL;
+        for (list<region*>::iterator iter = regionsGoalIn.begin(); iter != regionsGoalIn.end(); iter++) {
+            double distRegion = 0.0;
+            for (int i = 0; i < numDimensions; i++) {
+                double distCurr = fabs (stateCenter[i] - (*iter)->center[i]) - (*iter)->size[i]/2.0;
+                if (distCurr > 0.0)
+                    distRegion += distCurr*distCurr;
+            }
+            if (distRegion < distGoal)
+                distGoal = distRegion;
+        }
+        if (distGoal == HUGE_VAL)
+            distGoal = 0.0;
+
+        // Inside the obstacles the repulsion saturates at half a cell
+        double distObstacle = distanceField->getSignedDistance (&(stateCenter[0]));
+        if (distObstacle < resolution/2.0)
+            distObstacle = resolution/2.0;
+
+        double repulsion = 0.0;
+        if (distObstacle < influenceDistanceIn)
+            repulsion = (1.0/distObstacle - 1.0/influenceDistanceIn);
+
+        potential[k] = sqrt (distGoal) + repulsiveGainIn/2.0*repulsion*repulsion;
+    }
+
+    // Gradient by central differences, one sided on the boundary of the grid
+    gradient.resize (numCellsTotal*numDimensions);
+    for (int k = 0; k < numCellsTotal; k++) {
+        for (int i = 0; i < numDimensions; i++) {
+
+            int cellCurr = (k/strides[i]) % numCells[i];
+            int kLow = (cellCurr > 0) ? k - strides[i] : k;
+            int kHigh = (cellCurr < numCells[i] - 1) ? k + strides[i] : k;
+
+            if (kLow == kHigh)
+                gradient[k*numDimensions + i] = 0.0;
+            else
+                gradient[k*numDimensions + i] = (potential[kHigh] - potential[kLow])/((kHigh - kLow)/strides[i]*resolution);
+        }
+    }
+
+    return 1;
+}
+
+
+int PotentialField::getCorners (const double *stateIn, int *cornerIndicesOut, double *cornerWeightsOut) {
+
+    int numCorners = 1 << numDimensions;
+
+    for (int c = 0; c < numCorners; c++) {
+        cornerIndicesOut[c] = 0;
+        cornerWeightsOut[c] = 1.0;
+    }
+
+    for (int i = 0; i < numDimensions; i++) {
+
+        // Position relative to the cell centers, clamped to the grid
+        double t = (stateIn[i] - origin[i])/resolution - 0.5;
+        int cellLow = (int)floor (t);
+        if (cellLow < 0)
+            cellLow = 0;
+        if (cellLow > numCells[i] - 2)
+            cellLow = numCells[i] - 2;
+        if (cellLow < 0)
+            cellLow = 0;
+
+        double fraction = t - cellLow;
+        if (fraction < 0.0)
+            fraction = 0.0;
+        if (fraction > 1.0)
+            fraction = 1.0;
+        int cellHigh = (cellLow + 1 < numCells[i]) ? cellLow + 1 : cellLow;
+
+        for (int c = 0; c < numCorners; c++) {
+            if (c & (1 << i)) {
+                cornerIndicesOut[c] += cellHigh*strides[i];
+                cornerWeightsOut[c] *= fraction;
+            }
+            else {
+                cornerIndicesOut[c] += cellLow*strides[i];
+                cornerWeightsOut[c] *= 1.0 - fraction;
+            }
+        }
+    }
+
+    return numCorners;
+}
+
+
+double PotentialField::getPotential (const double *stateIn) {
+
+    if (potential.empty())
+        return 0.0;
+
+    int cornerIndices[1 << POTENTIAL_FIELD_MAX_DIMENSIONS];
+    double cornerWeights[1 << POTENTIAL_FIELD_MAX_DIMENSIONS];
+    int numCorners = getCorners (stateIn, cornerIndices, cornerWeights);
+
+    double potentialOut = 0.0;
+    for (int c = 0; c < numCorners; c++)
+        potentialOut += cornerWeights[c]*potential[cornerIndices[c]];
+
+    return potentialOut;
+}
+
+
+int PotentialField::getGradient (const double *stateIn, double *gradientOut) {
+
+    for (int i = 0; i < numDimensions; i++)
+        gradientOut[i] = 0.0;
+
+    if (gradient.empty())
+        return 0;
+
+    int cornerIndices[1 << POTENTIAL_FIELD_MAX_DIMENSIONS];
+    double cornerWeights[1 << POTENTIAL_FIELD_MAX_DIMENSIONS];
+    int numCorners = getCorners (stateIn, cornerIndices, cornerWeights);
+
+    for (int c = 0; c < numCorners; c++)
+        for (int i = 0; i < numDimensions; i++)
+            gradientOut[i] += cornerWeights[c]*gradient[cornerIndices[c]*numDimensions + i];
+
+    return 1;
+}
@@ -0,0 +1,136 @@
+/*!
+ * \file potential_field.h
+ */
+
+#ifndef __RRTS_POTENTIAL_FIELD_H_
+#define __RRTS_POTENTIAL_FIELD_H_
+
+#include <list>
+#include <vector>
+
+#include "system_single_integrator.h"
+#include "distance_field.h"
+
+
+
+namespace SingleIntegrator {
+
+
+    /*!
+     * \brief Artificial potential field over a regular grid
+     *
+     * The potential is the sum of an attractive term, the distance to the goal
+     * region, and a repulsive term, repulsiveGain/2*(1/d - 1/d0)^2 where d is
+     * the distance to the nearest obstacle and d0 the influence distance. The
+     * potential and its gradient are stored at the cell centers and
+     * interpolated multilinearly between them. The obstacle distances come
+     * from a signed distance field at the same resolution, which is shared
+     * with the collision checker when it uses one at that resolution.
+     */
+    class PotentialField {
+
+        int numDimensions;
+        double resolution;
+
+        std::vector<double> origin;
+        std::vector<int> numCells;
+        std::vector<int> strides;
+
+        std::vector<double> potential;
+        // Gradient of each cell, gradient[k*numDimensions + i] is the derivative along dimension i
+        std::vector<double> gradient;
+
+        // Points to distanceFieldOwn, or to a shared field given to build
+        DistanceField *distanceField;
+        DistanceField distanceFieldOwn;
+
+        // Interpolation weights of the 2^numDimensions cells around the point
+        int getCorners (const double *stateIn, int *cornerIndicesOut, double *cornerWeightsOut);
+
+    public:
+
+        /*!
+         * \brief PotentialField constructor
+         *
+         * More elaborate description
+         */
+        PotentialField ();
+
+        /*!
+         * \brief PotentialField destructor
+         *
+         * More elaborate description
+         */
+        ~PotentialField ();
+
+        /*!
+         * \brief Potential fields are not copied, they may point to their own distance field
+         *
+         * More elaborate description
+         */
+        PotentialField (const PotentialField& potentialFieldIn) = delete;
+        PotentialField& operator= (const PotentialField& potentialFieldIn) = delete;
+
+        /*!
+         * \brief Computes the potential and its gradient over the operating region
+         *
+         * Supports up to 10 dimensions. A distance field that was built over
+         * the same operating region and obstacles at the same resolution is
+         * used instead of building a new one.
+         *
+         * \param regionOperatingIn The region covered by the grid
+         * \param regionsGoalIn The goal regions, the attractive potential is the distance to the nearest one
+         * \param obstaclesIn The list of obstacles
+         * \param numDimensionsIn Dimensionality of the grid
+         * \param resolutionIn The edge length of a cell
+         * \param influenceDistanceIn The distance beyond which the obstacles do not repel
+         * \param repulsiveGainIn The weight of the repulsive potential
+         * \param distanceFieldIn A distance field of the obstacles to share, or NULL
+         *
+         */
+        int build (region& regionOperatingIn, std::list<region*>& regionsGoalIn, std::list<region*>& obstaclesIn, int numDimensionsIn,
+                   double resolutionIn, double influenceDistanceIn, double repulsiveGainIn,
+                   DistanceField *distanceFieldIn);
+
+        /*!
+         * \brief Returns the edge length of a cell
+         *
+         * More elaborate description
+         */
+        double getResolution () {return resolution;}
+
+        /*!
+         * \brief Returns the interpolated potential at the point
+         *
+         * Points outside the grid take the value at the nearest point of the grid.
+         *
+         * \param stateIn The point, an array of dimension numDimensions
+         *
+         */
+        double getPotential (const double *stateIn);
+
+        /*!
+         * \brief Returns the interpolated gradient of the potential at the point
+         *
+         * More elaborate description
+         *
+         * \param stateIn The point, an array of dimension numDimensions
+         * \param gradientOut The gradient, an array of dimension numDimensions
+         *
+         */
+        int getGradient (const double *stateIn, double *gradientOut);
+
+        /*!
+         * \brief Returns a lower bound on the distance from the point to the obstacles
+         *
+         * See DistanceField::getClearance.
+         *
+         * \param stateIn The point, an array of dimension numDimensions
+         *
+         */
+        double getClearance (const double *stateIn) {return distanceField->getClearance (stateIn);}
+    };
+}
+
+
+#endif
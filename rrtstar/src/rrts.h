@@ -7,6 +7,10 @@
 
 
 #include "kdtree.h"
+#include "extension_queries.h"
+#include "system_traits.h"
+#include "sample_pipeline.h"
+#include "sampler.h"
 
 #include <list>
 #include <set>
@@ -20,6 +24,15 @@ namespace RRTstar {
     template<class State, class Trajectory, class System>
     class Planner;
 
+    template<class State, class Trajectory, class System>
+    class BatchPlanner;
+
+    template<class State, class Trajectory, class System>
+    class BidirectionalPlanner;
+
+    template<class State, class Trajectory, class System>
+    class PathOptimizer;
+
 
     /*!
      * \brief RRT* Vertex class
@@ -62,6 +75,17 @@ namespace RRTstar {
          *
          */
         Vertex (const Vertex &vertexIn); // copy constructor
+        
+        /*!
+         * \brief Vertex move constructor
+         *
+         * Takes over the state and the trajectory of vertexIn. As in the copy
+         * constructor, the links to the parent and the children are copied.
+         * 
+         * \param vertexIn A reference to the vertex to be moved.
+         *
+         */
+        Vertex (Vertex &&vertexIn);
 
         /*!
          * \brief Returns a reference to the state
@@ -92,6 +116,9 @@ namespace RRTstar {
         double getCost () {return costFromRoot;} //Returns the accumulated cost at this vertex
     
         friend class Planner<State,Trajectory,System>; // Friend Class Planner!!!
+        friend class BatchPlanner<State,Trajectory,System>;
+        friend class BidirectionalPlanner<State,Trajectory,System>;
+        friend class PathOptimizer<State,Trajectory,System>;
     };
 
     
@@ -103,6 +130,7 @@ namespace RRTstar {
     template<class State, class Trajectory, class System>
     class Planner {
 
+    protected:
 
         typedef struct kdtree KdTree; 
         typedef struct kdres KdRes;  
@@ -125,16 +153,45 @@ namespace RRTstar {
         int getNearestVertex (State& stateIn, vertex_t*& vertexPointerOut); 
         int getNearVertices (State& stateIn, std::vector<vertex_t*>& vectorNearVerticesOut);  
         
+        // The vertices that reach the target, checked once when they join the tree
+        std::set<vertex_t*> goalVertices;
+        
         int checkUpdateBestVertex (vertex_t& vertexIn); 
+        int updateBestVertex ();
         
-        vertex_t* insertTrajectory (vertex_t& vertexStartIn, Trajectory& trajectoryIn);  
+        vertex_t* insertTrajectory (vertex_t& vertexStartIn, Trajectory&& trajectoryIn);  
         int insertTrajectory (vertex_t& vertexStartIn, Trajectory& trajectoryIn, vertex_t& vertexEndIn); 
+        int insertTrajectory (vertex_t& vertexStartIn, Trajectory&& trajectoryIn, vertex_t& vertexEndIn); 
         
         int findBestParent (State& stateIn, std::vector<vertex_t*>& vectorNearVerticesIn, 
                             vertex_t*& vertexBestOut, Trajectory& trajectoryOut, bool& exactConnection); 
     
         int updateBranchCost (vertex_t& vertexIn, int depth);   
         int rewireVertices (vertex_t& vertexNew, std::vector<vertex_t*>& vectorNearVertices);  
+        
+        int extendTree (State& stateIn, vertex_t*& vertexNewOut);
+        
+        int rebuildKdtree ();
+        
+        unsigned long treeRevision;
+        
+        std::vector<double> bestPathCache;
+        std::vector<vertex_t*> bestPathCacheVertices;
+        vertex_t *bestPathCacheVertex;
+        double bestPathCacheCost;
+        unsigned long bestPathCacheRevision;
+        
+        int updateBestPathCache ();
+        
+        SamplePipeline<State,System> *samplePipeline;
+        
+        int drawSample (State& stateOut);
+        
+        Sampler sampler;
+        double goalBias;
+        double goalConnectionDistance;
+        
+        int connectToGoal (vertex_t& vertexIn);
 
     
     public:
@@ -201,6 +258,55 @@ namespace RRTstar {
         int setSystem (System& system);
         
         
+        /*!
+         * \brief Makes the planner take its samples from a sample pipeline
+         *
+         * The planner draws the samples itself while the pipeline is not
+         * running. Pass NULL to stop using the pipeline.
+         *
+         * \param samplePipelineIn A pointer to the pipeline, started on the system of the planner
+         *
+         */
+        int setSamplePipeline (SamplePipeline<State,System>* samplePipelineIn);
+        
+        
+        /*!
+         * \brief Sets the probability of sampling from the goal region
+         *
+         * A sample is drawn with System::sampleGoalState with this probability
+         * and with System::sampleState otherwise. The default is zero. The goal
+         * states are drawn with the sampler of the planner, not the one of the
+         * system, so goal bias is safe while a sample pipeline runs.
+         *
+         * \param goalBiasIn The probability, in [0,1]
+         *
+         */
+        int setGoalBias (double goalBiasIn);
+        
+        
+        /*!
+         * \brief Sets the distance within which new vertices are connected to the goal directly
+         *
+         * Each new vertex whose cost-to-go is at most this distance is extended
+         * towards a state sampled from the goal region with the sampler of the
+         * planner, as for the goal bias. The default is zero, which disables
+         * the connections.
+         *
+         * \param goalConnectionDistanceIn The distance, zero or larger
+         *
+         */
+        int setGoalConnectionDistance (double goalConnectionDistanceIn);
+        
+        
+        /*!
+         * \brief Returns the sampler that draws the goal bias and the goal states
+         *
+         * Seed it with Sampler::setSeed for reproducible goal-biased runs. The
+         * samples of the system are drawn with the sampler of the system.
+         */
+        Sampler& getSampler () {return sampler;}
+        
+        
         /*!
          * \brief Returns a reference to the root vertex
          *
@@ -210,9 +316,46 @@ namespace RRTstar {
         
         
         /*!
-         * \brief Initializes the RRT* algorithm
+         * \brief Makes the given vertex the new root of the tree
+         *
+         * Reverses the edges on the path from the current root to the given
+         * vertex and recomputes the costs of the tree. All the other vertices
+         * and the kdtree are kept, so the planner can continue from the current
+         * tree as the robot moves. The tree is left unchanged if one of the
+         * reversed edges can not be generated by the system. The new root is
+         * passed to System::setRootState, so stop a running sample pipeline
+         * first.
+         *
+         * \param vertexIn The vertex that becomes the new root
+         *
+         */
+        int rerootTree (vertex_t& vertexIn);
+        
+        /*!
+         * \brief Makes the vertex nearest to the given state the new root of the tree
          *
          * More elaborate description
+         *
+         * \param stateIn The state of the robot
+         *
+         */
+        int rerootTree (State& stateIn);
+        
+        /*!
+         * \brief Repairs the tree after the obstacles of the system changed
+         *
+         * Only the edges that cross a region blocked since the last update are
+         * invalidated. The affected subtrees are reconnected to the rest of the
+         * tree through their near vertices, and the vertices that can not be
+         * reconnected are removed. The vertices near the freed regions are
+         * rewired. The recorded changes are cleared in the system afterwards.
+         */
+        int updateObstacles ();
+        
+        /*!
+         * \brief Initializes the RRT* algorithm
+         *
+         * Keeps the root vertex and passes its state to System::setRootState.
          */
         int initialize ();
 
@@ -237,6 +380,23 @@ namespace RRTstar {
          */
         vertex_t& getBestVertex () {return *lowerBoundVertex;}
         
+        /*!
+         * \brief Returns the number of vertices that reach the target
+         *
+         * The best vertex is maintained over these vertices only, so that
+         * updating it after a rewiring does not depend on the size of the
+         * rewired branch.
+         */
+        int getNumGoalVertices () {return goalVertices.size();}
+        
+        /*!
+         * \brief Checks all the vertices against the target and updates the best vertex
+         *
+         * The vertices are checked against the target when they join the tree,
+         * so call this after the goal regions of the system change.
+         */
+        int updateGoalVertices ();
+        
         /*!
          * \brief Returns the best trajectory as a list of double arrays
          *
@@ -248,6 +408,27 @@ namespace RRTstar {
          *
          */
         int getBestTrajectory (std::list<double*>& trajectory);
+        
+        /*!
+         * \brief Returns the number of states in the best path
+         *
+         * Returns zero if no path to the goal has been found.
+         */
+        int getBestPathNumStates ();
+        
+        /*!
+         * \brief Writes the best path into a contiguous buffer
+         *
+         * The path is cached and only regenerated when the best vertex, its cost
+         * or the structure of the tree changes, so repeated calls do not allocate.
+         *
+         * \param pathOut A buffer of at least maxNumStatesIn*system->getNumDimensions()
+         *                doubles. The states are written one after the other.
+         * \param maxNumStatesIn The maximum number of states to write
+         *
+         * Returns the number of states written.
+         */
+        int getBestPath (double *pathOut, int maxNumStatesIn);
     };
 
 }
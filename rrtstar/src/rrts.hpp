@@ -9,9 +9,11 @@
 #include <cfloat>
 #include <cmath>
 #include <algorithm>
+#include <utility>
 
 
 #include "rrts.h"
+#include "sample_pipeline.hpp"
 
 
 
@@ -61,6 +63,21 @@ RRTstar::Vertex<State, Trajectory, System>
 }
 
 
+template<class State, class Trajectory, class System>
+RRTstar::Vertex<State, Trajectory, System>
+::Vertex(Vertex<State, Trajectory, System>&& vertexIn) {
+    
+    state = vertexIn.state;
+    vertexIn.state = NULL;
+    parent = vertexIn.parent;
+    children = vertexIn.children;
+    costFromParent = vertexIn.costFromParent;
+    costFromRoot = vertexIn.costFromRoot;
+    trajFromParent = vertexIn.trajFromParent;
+    vertexIn.trajFromParent = NULL;
+}
+
+
 
 template<class State, class Trajectory, class System>
 RRTstar::Planner<State, Trajectory, System>
@@ -78,6 +95,17 @@ RRTstar::Planner<State, Trajectory, System>
     numVertices = 0;
     
     system = NULL;
+    
+    treeRevision = 0;
+    
+    bestPathCacheVertex = NULL;
+    bestPathCacheCost = DBL_MAX;
+    bestPathCacheRevision = 0;
+    
+    samplePipeline = NULL;
+    
+    goalBias = 0.0;
+    goalConnectionDistance = 0.0;
 }
 
 
@@ -156,26 +184,44 @@ RRTstar::Planner<State, Trajectory, System>
     delete [] stateKey;
     
     // Create the vector data structure for storing the results
-    int numNearVertices = kd_res_size (kdres);
-    if (numNearVertices == 0) {
-        vectorNearVerticesOut.clear();
-        return 1;
-    }
-    vectorNearVerticesOut.resize(numNearVertices);
+    vectorNearVerticesOut.clear();
+    vectorNearVerticesOut.reserve (kd_res_size (kdres));
     
-    // Place pointers to the near vertices into the vector 
-    int i = 0;
+    // Place pointers to the near vertices into the vector
     kd_res_rewind (kdres);
     while (!kd_res_end(kdres)) {
         Vertex<State,Trajectory,System> *vertexCurr = (Vertex<State,Trajectory,System> *) kd_res_item_data (kdres);
-        vectorNearVerticesOut[i] = vertexCurr;
+        vectorNearVerticesOut.push_back (vertexCurr);
         kd_res_next (kdres);
-        i++;
     }
     
     // Free temporary memory
     kd_res_free (kdres);
     
+    // Leave out the vertices farther than the maximum extension length
+    double maxExtensionLength = system->getMaxExtensionLength ();
+    int numNearVertices = vectorNearVerticesOut.size();
+    if ( (maxExtensionLength == HUGE_VAL) || (numNearVertices == 0) )
+        return 1;
+    
+    std::vector<State*> statesNear (numNearVertices);
+    for (int i = 0; i < numNearVertices; i++)
+        statesNear[i] = vectorNearVerticesOut[i]->state;
+    
+    double *costs = new double[numNearVertices];
+    bool *exactConnections = new bool[numNearVertices];
+    ExtensionQueries<State,Trajectory,System>::evaluateExtensionCosts (*system, stateIn, &(statesNear[0]), numNearVertices, 
+                                                                       false, costs, exactConnections);
+    
+    int numKept = 0;
+    for (int i = 0; i < numNearVertices; i++)
+        if (costs[i] <= maxExtensionLength)
+            vectorNearVerticesOut[numKept++] = vectorNearVerticesOut[i];
+    vectorNearVerticesOut.resize (numKept);
+    
+    delete [] costs;
+    delete [] exactConnections;
+    
     return 1;
 }
 
@@ -185,7 +231,7 @@ int
 RRTstar::Planner<State, Trajectory, System>
 ::checkUpdateBestVertex (Vertex<State,Trajectory,System>& vertexIn) {
     
-    if (system->isReachingTarget(vertexIn.getState())){
+    if (goalVertices.find (&vertexIn) != goalVertices.end()) {
         
         
         double costCurr = vertexIn.getCost();
@@ -200,10 +246,50 @@ RRTstar::Planner<State, Trajectory, System>
 }
 
 
+template<class State, class Trajectory, class System>
+int
+RRTstar::Planner<State, Trajectory, System>
+::updateBestVertex () {
+    
+    lowerBoundCost = DBL_MAX;
+    lowerBoundVertex = NULL;
+    
+    for (typename std::set< Vertex<State,Trajectory,System>* >::iterator iter = goalVertices.begin(); iter != goalVertices.end(); iter++) {
+        
+        double costCurr = (*iter)->getCost();
+        if ( (lowerBoundVertex == NULL) || (costCurr < lowerBoundCost) ) {
+            lowerBoundVertex = *iter;
+            lowerBoundCost = costCurr;
+        }
+    }
+    
+    return 1;
+}
+
+
+template<class State, class Trajectory, class System>
+int
+RRTstar::Planner<State, Trajectory, System>
+::updateGoalVertices () {
+    
+    if (!system)
+        return 0;
+    
+    goalVertices.clear();
+    for (typename std::list< Vertex<State,Trajectory,System>* >::iterator iter = listVertices.begin(); iter != listVertices.end(); iter++)
+        if (system->isReachingTarget ((*iter)->getState()))
+            goalVertices.insert (*iter);
+    
+    updateBestVertex ();
+    
+    return 1;
+}
+
+
 template<class State, class Trajectory, class System>
 RRTstar::Vertex<State,Trajectory,System>*
 RRTstar::Planner<State, Trajectory, System>
-::insertTrajectory (Vertex<State,Trajectory,System>& vertexStartIn, Trajectory& trajectoryIn) {
+::insertTrajectory (Vertex<State,Trajectory,System>& vertexStartIn, Trajectory&& trajectoryIn) {
     
     // Check for admissible cost-to-go
     if (lowerBoundVertex != NULL) {
@@ -215,15 +301,14 @@ RRTstar::Planner<State, Trajectory, System>
     
     // Create a new end vertex
     Vertex<State,Trajectory,System>* vertexNew = new Vertex<State,Trajectory,System>;
-    vertexNew->state = new State;
+    vertexNew->state = new State (trajectoryIn.getEndState());
     vertexNew->parent = NULL;
-    vertexNew->getState() = trajectoryIn.getEndState();
     insertIntoKdtree (*vertexNew);  
     this->listVertices.push_front (vertexNew);
     this->numVertices++;
     
-    // Insert the trajectory between the start and end vertices
-    insertTrajectory (vertexStartIn, trajectoryIn, *vertexNew);
+    // Move the trajectory between the start and end vertices into the tree
+    insertTrajectory (vertexStartIn, std::move (trajectoryIn), *vertexNew);
     
     return vertexNew;
 }
@@ -234,6 +319,19 @@ int
 RRTstar::Planner<State, Trajectory, System>
 ::insertTrajectory (Vertex<State,Trajectory,System>& vertexStartIn, Trajectory& trajectoryIn, Vertex<State,Trajectory,System>& vertexEndIn) {
     
+    return insertTrajectory (vertexStartIn, Trajectory (trajectoryIn), vertexEndIn);
+}
+
+
+template<class State, class Trajectory, class System>
+int 
+RRTstar::Planner<State, Trajectory, System>
+::insertTrajectory (Vertex<State,Trajectory,System>& vertexStartIn, Trajectory&& trajectoryIn, Vertex<State,Trajectory,System>& vertexEndIn) {
+    
+    // Check a vertex against the target when it joins the tree
+    if ( (vertexEndIn.parent == NULL) && system->isReachingTarget (vertexEndIn.getState()) )
+        goalVertices.insert (&vertexEndIn);
+    
     // Update the costs
     vertexEndIn.costFromParent = trajectoryIn.evaluateCost();
     vertexEndIn.costFromRoot = vertexStartIn.costFromRoot + vertexEndIn.costFromParent;
@@ -242,7 +340,9 @@ RRTstar::Planner<State, Trajectory, System>
     // Update the trajectory between the two vertices
     if (vertexEndIn.trajFromParent)
         delete vertexEndIn.trajFromParent;
-    vertexEndIn.trajFromParent = new Trajectory (trajectoryIn);
+    vertexEndIn.trajFromParent = NULL;
+    if (SystemTraits<System>::storeTrajectories)
+        vertexEndIn.trajFromParent = new Trajectory (std::move (trajectoryIn));
     
     // Update the parent to the end vertex
     if (vertexEndIn.parent)
@@ -272,8 +372,10 @@ RRTstar::Planner<State, Trajectory, System>
     for (typename std::list< Vertex<State,Trajectory,System>* >::iterator iter = listVertices.begin(); iter != listVertices.end(); iter++)
         delete *iter;
     numVertices = 0;
+    goalVertices.clear();
     lowerBoundCost = DBL_MAX;
     lowerBoundVertex = NULL;
+    treeRevision++;
     
     // Clear the kdtree
     if (kdtree) {
@@ -293,6 +395,60 @@ RRTstar::Planner<State, Trajectory, System>
 }
 
 
+template<class State, class Trajectory, class System>
+int 
+RRTstar::Planner<State, Trajectory, System>
+::setSamplePipeline (SamplePipeline<State,System>* samplePipelineIn) {
+    
+    samplePipeline = samplePipelineIn;
+    
+    return 1;
+}
+
+
+template<class State, class Trajectory, class System>
+int 
+RRTstar::Planner<State, Trajectory, System>
+::setGoalBias (double goalBiasIn) {
+    
+    if ( (goalBiasIn < 0.0) || (goalBiasIn > 1.0) )
+        return 0;
+    
+    goalBias = goalBiasIn;
+    
+    return 1;
+}
+
+
+template<class State, class Trajectory, class System>
+int 
+RRTstar::Planner<State, Trajectory, System>
+::setGoalConnectionDistance (double goalConnectionDistanceIn) {
+    
+    if (goalConnectionDistanceIn < 0.0)
+        return 0;
+    
+    goalConnectionDistance = goalConnectionDistanceIn;
+    
+    return 1;
+}
+
+
+template<class State, class Trajectory, class System>
+int 
+RRTstar::Planner<State, Trajectory, System>
+::drawSample (State& stateOut) {
+    
+    if ( (goalBias > 0.0) && (sampler.sampleUniform () < goalBias) )
+        return system->sampleGoalState (stateOut, sampler);
+    
+    if (samplePipeline && samplePipeline->isRunning ())
+        return samplePipeline->getSample (stateOut);
+    
+    return system->sampleState (stateOut);
+}
+
+
 
 template<class State, class Trajectory, class System>
 RRTstar::Vertex<State, Trajectory, System>& 
@@ -323,8 +479,10 @@ RRTstar::Planner<State, Trajectory, System>
         delete *iter;
     listVertices.clear();
     numVertices = 0;
+    goalVertices.clear();
     lowerBoundCost = DBL_MAX;
     lowerBoundVertex = NULL;
+    treeRevision++;
     
     // Clear the kdtree
     if (kdtree) {
@@ -340,14 +498,101 @@ RRTstar::Planner<State, Trajectory, System>
         listVertices.push_back(root);
         insertIntoKdtree (*root);
         numVertices++;
+        if (system->isReachingTarget (root->getState()))
+            goalVertices.insert (root);
+        system->setRootState (root->getState());
     }
-    lowerBoundCost = DBL_MAX;
-    lowerBoundVertex = NULL;
+    updateBestVertex ();
+    
+    return 1;
+}
+
+
+template<class State, class Trajectory, class System>
+int 
+RRTstar::Planner<State, Trajectory, System>
+::rerootTree (Vertex<State,Trajectory,System>& vertexIn) {
+    
+    if ( (root == NULL) || (&vertexIn == root) )
+        return 0;
+    
+    // Collect the path from the new root to the current root
+    std::vector< Vertex<State,Trajectory,System>* > vectorPathVertices;
+    Vertex<State,Trajectory,System>* vertexCurr = &vertexIn;
+    while (vertexCurr) {
+        vectorPathVertices.push_back (vertexCurr);
+        vertexCurr = vertexCurr->parent;
+    }
+    if (vectorPathVertices.back() != root)
+        return 0;
+    
+    // Generate all the reversed trajectories before modifying the tree
+    int numPathEdges = vectorPathVertices.size() - 1;
+    std::vector<Trajectory*> vectorReversedTrajectories (numPathEdges, (Trajectory*)NULL);
+    for (int i = 0; i < numPathEdges; i++) {
+        
+        vectorReversedTrajectories[i] = new Trajectory;
+        bool exactConnection = false;
+        if ( (system->extendTo (vectorPathVertices[i]->getState(), vectorPathVertices[i+1]->getState(), 
+                                *(vectorReversedTrajectories[i]), exactConnection) <= 0) || (exactConnection == false) ) {
+            for (int j = 0; j <= i; j++) 
+                delete vectorReversedTrajectories[j];
+            return 0;
+        }
+    }
+    
+    // Reverse the edges on the path
+    for (int i = 0; i < numPathEdges; i++) {
+        
+        Vertex<State,Trajectory,System>& vertexChild = *(vectorPathVertices[i]);
+        Vertex<State,Trajectory,System>& vertexParent = *(vectorPathVertices[i+1]);
+        
+        vertexParent.children.erase (&vertexChild);
+        vertexChild.children.insert (&vertexParent);
+        vertexParent.parent = &vertexChild;
+        
+        if (vertexParent.trajFromParent)
+            delete vertexParent.trajFromParent;
+        vertexParent.trajFromParent = NULL;
+        vertexParent.costFromParent = vectorReversedTrajectories[i]->evaluateCost();
+        if (SystemTraits<System>::storeTrajectories)
+            vertexParent.trajFromParent = vectorReversedTrajectories[i];
+        else
+            delete vectorReversedTrajectories[i];
+    }
+    
+    root = &vertexIn;
+    root->parent = NULL;
+    if (root->trajFromParent)
+        delete root->trajFromParent;
+    root->trajFromParent = NULL;
+    root->costFromParent = 0.0;
+    root->costFromRoot = 0.0;
+    treeRevision++;
+    
+    system->setRootState (root->getState());
+    
+    // Recompute the costs and the best vertex with respect to the new root
+    updateBranchCost (*root, 0);
+    updateBestVertex ();
     
     return 1;
 }
 
 
+template<class State, class Trajectory, class System>
+int 
+RRTstar::Planner<State, Trajectory, System>
+::rerootTree (State& stateIn) {
+    
+    Vertex<State,Trajectory,System>* vertexNearest = NULL;
+    if (getNearestVertex (stateIn, vertexNearest) <= 0) 
+        return 0;
+    
+    return rerootTree (*vertexNearest);
+}
+
+
 template<class State, class Trajectory, class System>
 int 
 RRTstar::Planner<State, Trajectory, System>
@@ -371,6 +616,147 @@ int compareVertexCostPairs (std::pair<RRTstar::Vertex<State,Trajectory,System>*,
 }
 
 
+template<class State, class Trajectory, class System>
+int 
+RRTstar::Planner<State, Trajectory, System>
+::rebuildKdtree () {
+    
+    if (kdtree) {
+        kd_clear (kdtree);
+        kd_free (kdtree);
+    }
+    kdtree = kd_create (numDimensions);
+    
+    for (typename std::list< Vertex<State,Trajectory,System>* >::iterator iter = listVertices.begin(); iter != listVertices.end(); iter++)
+        insertIntoKdtree (**iter);
+    
+    return 1;
+}
+
+
+template<class State, class Trajectory, class System>
+int 
+RRTstar::Planner<State, Trajectory, System>
+::updateObstacles () {
+    
+    if ( (root == NULL) || (system->hasObstacleUpdates() == false) )
+        return 1;
+    
+    // 1. Detach the vertices whose edge from the parent crosses a blocked region
+    std::vector< Vertex<State,Trajectory,System>* > vectorInvalidVertices;
+    for (typename std::list< Vertex<State,Trajectory,System>* >::iterator iter = listVertices.begin(); iter != listVertices.end(); iter++) {
+        Vertex<State,Trajectory,System>* vertexCurr = *iter;
+        if ( vertexCurr->parent && system->isBlockedByObstacleUpdate (vertexCurr->parent->getState(), vertexCurr->getState()) )
+            vectorInvalidVertices.push_back (vertexCurr);
+    }
+    
+    std::set< Vertex<State,Trajectory,System>* > setOrphans;
+    std::vector< Vertex<State,Trajectory,System>* > vectorStack;
+    for (typename std::vector< Vertex<State,Trajectory,System>* >::iterator iter = vectorInvalidVertices.begin(); iter != vectorInvalidVertices.end(); iter++) {
+        (*iter)->parent->children.erase (*iter);
+        (*iter)->parent = NULL;
+        vectorStack.push_back (*iter);
+    }
+    
+    // 2. Collect the subtrees of the detached vertices
+    while (vectorStack.size() > 0) {
+        Vertex<State,Trajectory,System>* vertexCurr = vectorStack.back();
+        vectorStack.pop_back();
+        setOrphans.insert (vertexCurr);
+        for (typename std::set< Vertex<State,Trajectory,System>* >::iterator iter = vertexCurr->children.begin(); iter != vertexCurr->children.end(); iter++)
+            vectorStack.push_back (*iter);
+    }
+    
+    // 3. Reconnect the orphans in the order of their old cost, so that parents are handled before their children
+    std::vector< std::pair<Vertex<State,Trajectory,System>*,double> > vectorOrphanCostPairs;
+    for (typename std::set< Vertex<State,Trajectory,System>* >::iterator iter = setOrphans.begin(); iter != setOrphans.end(); iter++)
+        vectorOrphanCostPairs.push_back (std::pair<Vertex<State,Trajectory,System>*,double> (*iter, (*iter)->costFromRoot));
+    std::sort (vectorOrphanCostPairs.begin(), vectorOrphanCostPairs.end(), compareVertexCostPairs<State,Trajectory,System>);
+    
+    for (typename std::vector< std::pair<Vertex<State,Trajectory,System>*,double> >::iterator iter = vectorOrphanCostPairs.begin(); 
+         iter != vectorOrphanCostPairs.end(); iter++) {
+        
+        Vertex<State,Trajectory,System>* vertexCurr = iter->first;
+        
+        // The edge from a reconnected parent is still valid
+        if ( vertexCurr->parent && (setOrphans.find (vertexCurr->parent) == setOrphans.end()) ) {
+            vertexCurr->costFromRoot = vertexCurr->parent->costFromRoot + vertexCurr->costFromParent;
+            setOrphans.erase (vertexCurr);
+            continue;
+        }
+        
+        if (vertexCurr->parent) {
+            vertexCurr->parent->children.erase (vertexCurr);
+            vertexCurr->parent = NULL;
+        }
+        
+        // Try to connect to the near vertices that are still in the tree
+        std::vector< Vertex<State,Trajectory,System>* > vectorNearVertices;
+        getNearVertices (vertexCurr->getState(), vectorNearVertices);
+        std::vector< Vertex<State,Trajectory,System>* > vectorParentCandidates;
+        for (typename std::vector< Vertex<State,Trajectory,System>* >::iterator iterNear = vectorNearVertices.begin(); iterNear != vectorNearVertices.end(); iterNear++)
+            if (setOrphans.find (*iterNear) == setOrphans.end())
+                vectorParentCandidates.push_back (*iterNear);
+        if (vectorParentCandidates.size() == 0)
+            continue;
+        
+        Vertex<State,Trajectory,System>* vertexParent = NULL;
+        Trajectory trajectory;
+        bool exactConnection = false;
+        if (findBestParent (vertexCurr->getState(), vectorParentCandidates, vertexParent, trajectory, exactConnection) <= 0)
+            continue;
+        if (exactConnection == false)
+            continue;
+        
+        insertTrajectory (*vertexParent, std::move (trajectory), *vertexCurr);
+        setOrphans.erase (vertexCurr);
+    }
+    
+    // 4. Remove the orphans that could not be reconnected
+    if (setOrphans.size() > 0) {
+        
+        typename std::list< Vertex<State,Trajectory,System>* >::iterator iter = listVertices.begin();
+        while (iter != listVertices.end()) {
+            Vertex<State,Trajectory,System>* vertexCurr = *iter;
+            if (setOrphans.find (vertexCurr) != setOrphans.end()) {
+                if (vertexCurr->parent)
+                    vertexCurr->parent->children.erase (vertexCurr);
+                goalVertices.erase (vertexCurr);
+                delete vertexCurr;
+                iter = listVertices.erase (iter);
+                numVertices--;
+            }
+            else
+                iter++;
+        }
+        
+        rebuildKdtree ();
+    }
+    
+    // 5. Rewire around the freed regions
+    double ballRadius = gamma * pow( log((double)(numVertices + 1.0))/((double)(numVertices + 1.0)), 1.0/((double)numDimensions) );
+    std::vector< Vertex<State,Trajectory,System>* > vectorFreedVertices;
+    for (typename std::list< Vertex<State,Trajectory,System>* >::iterator iter = listVertices.begin(); iter != listVertices.end(); iter++)
+        if (system->isNearFreedRegion ((*iter)->getState(), ballRadius))
+            vectorFreedVertices.push_back (*iter);
+    
+    for (typename std::vector< Vertex<State,Trajectory,System>* >::iterator iter = vectorFreedVertices.begin(); iter != vectorFreedVertices.end(); iter++) {
+        std::vector< Vertex<State,Trajectory,System>* > vectorNearVertices;
+        getNearVertices ((*iter)->getState(), vectorNearVertices);
+        rewireVertices (**iter, vectorNearVertices);
+    }
+    
+    // 6. Recompute the costs and the best vertex
+    treeRevision++;
+    updateBranchCost (*root, 0);
+    updateBestVertex ();
+    
+    system->clearObstacleUpdates ();
+    
+    return 1;
+}
+
+
 template<class State, class Trajectory, class System>
 int 
 RRTstar::Planner<State, Trajectory, System>
@@ -379,24 +765,32 @@ RRTstar::Planner<State, Trajectory, System>
     
     // Compute the cost of extension for each near vertex
     int numNearVertices = vectorNearVerticesIn.size();
+    if (numNearVertices == 0)
+        return 0;
     
     std::vector< std::pair<Vertex<State,Trajectory,System>*,double> > vectorVertexCostPairs(numNearVertices);
     
-    int i = 0;
-    for (typename std::vector< Vertex<State,Trajectory,System>* >::iterator iter = vectorNearVerticesIn.begin(); iter != vectorNearVerticesIn.end(); iter++) {
-        
-        vectorVertexCostPairs[i].first = *iter;
-        exactConnection = false;
-        double trajCost = system->evaluateExtensionCost ( *((*iter)->state), stateIn, exactConnection);
-        vectorVertexCostPairs[i].second = (*iter)->costFromRoot + trajCost;
-        i++;
+    std::vector<State*> statesNear (numNearVertices);
+    for (int i = 0; i < numNearVertices; i++)
+        statesNear[i] = vectorNearVerticesIn[i]->state;
+    
+    double *costs = new double[numNearVertices];
+    bool *exactConnections = new bool[numNearVertices];
+    ExtensionQueries<State,Trajectory,System>::evaluateExtensionCosts (*system, stateIn, &(statesNear[0]), numNearVertices, 
+                                                                       false, costs, exactConnections);
+    
+    for (int i = 0; i < numNearVertices; i++) {
+        vectorVertexCostPairs[i].first = vectorNearVerticesIn[i];
+        vectorVertexCostPairs[i].second = vectorNearVerticesIn[i]->costFromRoot + costs[i];
     }
     
+    delete [] costs;
+    delete [] exactConnections;
+    
     // Sort vertices according to cost
     std::sort (vectorVertexCostPairs.begin(), vectorVertexCostPairs.end(), compareVertexCostPairs<State,Trajectory,System>);
     
     // Try out each extension according to increasing cost
-    i = 0;
     bool connectionEstablished = false;
     for (typename std::vector< std::pair<Vertex<State,Trajectory,System>*,double> >::iterator iter = vectorVertexCostPairs.begin(); 
          iter != vectorVertexCostPairs.end(); iter++) {
@@ -434,8 +828,6 @@ RRTstar::Planner<State, Trajectory, System>
         
         vertex.costFromRoot = vertexIn.costFromRoot + vertex.costFromParent;
         
-        checkUpdateBestVertex (vertex);
-        
         updateBranchCost (vertex, depth + 1);
     }
     
@@ -451,34 +843,76 @@ RRTstar::Planner<State, Trajectory, System>
 ::rewireVertices (Vertex<State,Trajectory,System>& vertexNew, std::vector< Vertex<State,Trajectory,System>* >& vectorNearVertices) {
     
     
-    // Repeat for all vertices in the set of near vertices
-    for (typename std::vector< Vertex<State,Trajectory,System>* >::iterator iter = vectorNearVertices.begin(); iter != vectorNearVertices.end(); iter++) {
-        
-        Vertex<State,Trajectory,System>& vertexCurr = **iter; 
+    int numNearVertices = vectorNearVertices.size();
+    if (numNearVertices == 0)
+        return 1;
+    
+    // Compute the cost of extension towards all vertices in the set of near vertices
+    std::vector<State*> statesNear (numNearVertices);
+    for (int i = 0; i < numNearVertices; i++)
+        statesNear[i] = vectorNearVertices[i]->state;
+    
+    double *costs = new double[numNearVertices];
+    bool *exactConnections = new bool[numNearVertices];
+    ExtensionQueries<State,Trajectory,System>::evaluateExtensionCosts (*system, *(vertexNew.state), &(statesNear[0]), numNearVertices, 
+                                                                       true, costs, exactConnections);
+    
+    // Keep the vertices whose cost decreases through an exact connection to the new vertex
+    std::vector< Vertex<State,Trajectory,System>* > vectorCandidates;
+    vectorCandidates.reserve (numNearVertices);
+    int numCandidates = 0;
+    for (int i = 0; i < numNearVertices; i++) {
         
-        // Check whether the extension results in an exact connection
-        bool exactConnection = false;
-        double costCurr = system->evaluateExtensionCost (*(vertexNew.state), *(vertexCurr.state), exactConnection);
-        if ( (exactConnection == false) || (costCurr < 0) )
+        if ( (exactConnections[i] == false) || (costs[i] < 0) )
             continue;
         
-        // Check whether the cost of the extension is smaller than current cost
-        double totalCost = vertexNew.costFromRoot + costCurr;
-        if (totalCost < vertexCurr.costFromRoot - 0.001) {
+        if (vertexNew.costFromRoot + costs[i] < vectorNearVertices[i]->costFromRoot - 0.001) {
+            statesNear[numCandidates] = statesNear[i];
+            costs[numCandidates] = costs[i];
+            vectorCandidates.push_back (vectorNearVertices[i]);
+            numCandidates++;
+        }
+    }
+    
+    int numRewired = 0;
+    if (numCandidates > 0) {
+        
+        // Compute the extensions (checking for collision)
+        Trajectory *trajectories = new Trajectory[numCandidates];
+        bool *valid = new bool[numCandidates];
+        ExtensionQueries<State,Trajectory,System>::extendToStates (*system, *(vertexNew.state), &(statesNear[0]), numCandidates, 
+                                                                   true, trajectories, exactConnections, valid);
+        
+        for (int i = 0; i < numCandidates; i++) {
+            
+            Vertex<State,Trajectory,System>& vertexCurr = *(vectorCandidates[i]);
             
-            // Compute the extension (checking for collision)
-            Trajectory trajectory;
-            if (system->extendTo (*(vertexNew.state), *(vertexCurr.state), trajectory, exactConnection) <= 0 ) 
+            if (!valid[i])
+                continue;
+            
+            // Rewiring an earlier candidate may have lowered the cost of this one
+            if (vertexNew.costFromRoot + costs[i] >= vertexCurr.costFromRoot - 0.001)
                 continue;
             
             // Insert the new trajectory to the tree by rewiring
-            insertTrajectory (vertexNew, trajectory, vertexCurr);
+            insertTrajectory (vertexNew, std::move (trajectories[i]), vertexCurr);
             
             // Update the cost of all vertices in the rewired branch
             updateBranchCost (vertexCurr, 0);
+            numRewired++;
         }
+        
+        delete [] trajectories;
+        delete [] valid;
     }
     
+    // The rewired branches may hold goal vertices that became cheaper
+    if (numRewired > 0)
+        updateBestVertex ();
+    
+    delete [] costs;
+    delete [] exactConnections;
+    
     return 1;
 }
 
@@ -486,16 +920,21 @@ RRTstar::Planner<State, Trajectory, System>
 template<class State, class Trajectory, class System>
 int 
 RRTstar::Planner<State, Trajectory, System>
-::iteration () {
+::extendTree (State& stateIn, Vertex<State,Trajectory,System>*& vertexNewOut) {
     
+    vertexNewOut = NULL;
     
-    // 1. Sample a new state
-    State stateRandom;
-    system->sampleState (stateRandom);    
+    // 1. Steer the state to within the maximum extension length of the nearest vertex
+    if (system->getMaxExtensionLength () < HUGE_VAL) {
+        Vertex<State,Trajectory,System>* vertexNearest = NULL;
+        if (getNearestVertex (stateIn, vertexNearest) <= 0) 
+            return 0;
+        system->steerState (vertexNearest->getState(), stateIn);
+    }
     
     // 2. Compute the set of all near vertices
     std::vector< Vertex<State,Trajectory,System>* > vectorNearVertices;
-    getNearVertices (stateRandom, vectorNearVertices);
+    getNearVertices (stateIn, vectorNearVertices);
     
     
     // 3. Find the best parent and extend from that parent
@@ -506,20 +945,20 @@ RRTstar::Planner<State, Trajectory, System>
     if (vectorNearVertices.size() == 0) {
         
         // 3.a Extend the nearest
-        if (getNearestVertex (stateRandom, vertexParent) <= 0) 
+        if (getNearestVertex (stateIn, vertexParent) <= 0) 
             return 0;
-        if (system->extendTo(vertexParent->getState(), stateRandom, trajectory, exactConnection) <= 0)
+        if (system->extendTo(vertexParent->getState(), stateIn, trajectory, exactConnection) <= 0)
             return 0;
     }
     else {
         
         // 3.b Extend the best parent within the near vertices
-        if (findBestParent (stateRandom, vectorNearVertices, vertexParent, trajectory, exactConnection) <= 0) 
+        if (findBestParent (stateIn, vectorNearVertices, vertexParent, trajectory, exactConnection) <= 0) 
             return 0;
     }
     
     // 3.c add the trajectory from the best parent to the tree
-    Vertex<State,Trajectory,System>* vertexNew = insertTrajectory (*vertexParent, trajectory);
+    Vertex<State,Trajectory,System>* vertexNew = insertTrajectory (*vertexParent, std::move (trajectory));
     if (vertexNew == NULL) 
         return 0;
     
@@ -528,6 +967,59 @@ RRTstar::Planner<State, Trajectory, System>
     if (vectorNearVertices.size() > 0) 
         rewireVertices (*vertexNew, vectorNearVertices);
     
+    vertexNewOut = vertexNew;
+    
+    return 1;
+}
+
+
+template<class State, class Trajectory, class System>
+int 
+RRTstar::Planner<State, Trajectory, System>
+::iteration () {
+    
+    
+    // 1. Sample a new state
+    State stateRandom;
+    if (drawSample (stateRandom) <= 0)
+        return 0;
+    
+    // 2.-4. Connect the sample to the tree and rewire
+    Vertex<State,Trajectory,System>* vertexNew = NULL;
+    if (extendTree (stateRandom, vertexNew) <= 0)
+        return 0;
+    
+    // 5. Try to reach the goal region directly from the new vertex
+    if (goalConnectionDistance > 0.0)
+        connectToGoal (*vertexNew);
+    
+    return 1;
+}
+
+
+template<class State, class Trajectory, class System>
+int 
+RRTstar::Planner<State, Trajectory, System>
+::connectToGoal (Vertex<State,Trajectory,System>& vertexIn) {
+    
+    if (system->isReachingTarget (vertexIn.getState()))
+        return 0;
+    
+    // The cost-to-go is a lower bound on the cost of the connection
+    if (system->evaluateCostToGo (vertexIn.getState()) > goalConnectionDistance)
+        return 0;
+    
+    State stateGoal;
+    if (system->sampleGoalState (stateGoal, sampler) <= 0)
+        return 0;
+    
+    Trajectory trajectory;
+    bool exactConnection = false;
+    if ( (system->extendTo (vertexIn.getState(), stateGoal, trajectory, exactConnection) <= 0) || !exactConnection )
+        return 0;
+    
+    if (insertTrajectory (vertexIn, std::move (trajectory)) == NULL)
+        return 0;
     
     return 1;
 }
@@ -548,9 +1040,9 @@ RRTstar::Planner<State, Trajectory, System>
         
         State& stateCurr = vertexCurr->getState();
         
-        double *stateArrCurr = new double[2]; 
-        stateArrCurr[0] = stateCurr[0];
-        stateArrCurr[1] = stateCurr[1];
+        double *stateArrCurr = new double[numDimensions]; 
+        for (int i = 0; i < numDimensions; i++)
+            stateArrCurr[i] = stateCurr[i];
  
         
         trajectoryOut.push_front (stateArrCurr);
@@ -569,9 +1061,9 @@ RRTstar::Planner<State, Trajectory, System>
                 
                 double *stateArrFromParentCurr = *iter;
                 
-                stateArrCurr = new double[2];
-                stateArrCurr[0] = stateArrFromParentCurr[0];
-                stateArrCurr[1] = stateArrFromParentCurr[1];
+                stateArrCurr = new double[numDimensions];
+                for (int i = 0; i < numDimensions; i++)
+                    stateArrCurr[i] = stateArrFromParentCurr[i];
 
      
                 
@@ -588,4 +1080,84 @@ RRTstar::Planner<State, Trajectory, System>
 }
 
 
+template<class State, class Trajectory, class System>
+int 
+RRTstar::Planner<State, Trajectory, System>
+::updateBestPathCache () {
+    
+    if (lowerBoundVertex == NULL) {
+        bestPathCache.clear();
+        bestPathCacheVertex = NULL;
+        return 0;
+    }
+    
+    // The path only changes if the best vertex, its cost or the structure of the tree changes
+    if ( (bestPathCacheVertex == lowerBoundVertex) && (bestPathCacheCost == lowerBoundVertex->costFromRoot) 
+         && (bestPathCacheRevision == treeRevision) )
+        return 1;
+    
+    // Collect the vertices from the best vertex to the root
+    bestPathCacheVertices.clear();
+    Vertex<State,Trajectory,System>* vertexCurr = lowerBoundVertex;
+    while (vertexCurr) {
+        bestPathCacheVertices.push_back (vertexCurr);
+        vertexCurr = vertexCurr->parent;
+    }
+    
+    // Write the states from the root to the best vertex
+    bestPathCache.clear();
+    State& stateRoot = bestPathCacheVertices.back()->getState();
+    for (int i = 0; i < numDimensions; i++)
+        bestPathCache.push_back (stateRoot[i]);
+    
+    for (int j = bestPathCacheVertices.size() - 2; j >= 0; j--) {
+        
+        std::list<double*> trajectory;
+        system->getTrajectory (bestPathCacheVertices[j+1]->getState(), bestPathCacheVertices[j]->getState(), trajectory);
+        
+        for (std::list<double*>::iterator iter = trajectory.begin(); iter != trajectory.end(); iter++) {
+            for (int i = 0; i < numDimensions; i++)
+                bestPathCache.push_back ((*iter)[i]);
+            delete [] *iter;
+        }
+    }
+    
+    bestPathCacheVertex = lowerBoundVertex;
+    bestPathCacheCost = lowerBoundVertex->costFromRoot;
+    bestPathCacheRevision = treeRevision;
+    
+    return 1;
+}
+
+
+template<class State, class Trajectory, class System>
+int 
+RRTstar::Planner<State, Trajectory, System>
+::getBestPathNumStates () {
+    
+    if (updateBestPathCache () <= 0)
+        return 0;
+    
+    return bestPathCache.size()/numDimensions;
+}
+
+
+template<class State, class Trajectory, class System>
+int 
+RRTstar::Planner<State, Trajectory, System>
+::getBestPath (double *pathOut, int maxNumStatesIn) {
+    
+    if (updateBestPathCache () <= 0)
+        return 0;
+    
+    int numStates = bestPathCache.size()/numDimensions;
+    if (numStates > maxNumStatesIn)
+        numStates = maxNumStatesIn;
+    
+    std::copy (bestPathCache.begin(), bestPathCache.begin() + numStates*numDimensions, pathOut);
+    
+    return numStates;
+}
+
+
 #endif
@@ -0,0 +1,152 @@
+/*!
+ * \file rrts_batch.h
+ */
+
+#ifndef __RRTS_BATCH_H_
+#define __RRTS_BATCH_H_
+
+
+#include "rrts.h"
+
+#include <list>
+#include <queue>
+#include <set>
+#include <vector>
+
+
+
+namespace RRTstar {
+
+
+    /*!
+     * \brief Batch sampling (BIT*-style) planner class
+     *
+     * Samples the state space in batches and processes the candidate edges of
+     * the resulting implicit graph in the order of their heuristic cost
+     * g(v) + c(v,x) + h(x), computed with System::evaluateExtensionCost and
+     * System::evaluateCostToGo. The collision checker (System::extendTo) is
+     * only called for edges that can still improve the current solution.
+     * Edges that cost more than System::getMaxExtensionLength are not queued.
+     * The samples are not steered, so a sample farther than that from the
+     * tree waits until the tree grows towards it.
+     * The planner uses the same System interface and exposes the same public
+     * methods as Planner, so it can be used in its place.
+     */
+    template<class State, class Trajectory, class System>
+    class BatchPlanner : public Planner<State,Trajectory,System> {
+
+        typedef struct kdtree KdTree;
+        typedef struct kdres KdRes;
+        typedef Vertex<State,Trajectory,System> vertex_t;
+        typedef Planner<State,Trajectory,System> planner_t;
+
+        typedef std::pair<double, vertex_t*> vertex_queue_entry_t;
+
+        struct edge_t {
+            double key;
+            vertex_t *vertexFrom;
+            vertex_t *vertexTo;      // Set if the edge ends at a vertex of the tree
+            State **sampleTo;        // Set if the edge ends at an unconnected sample
+        };
+
+        struct compareVertexQueueEntries {
+            bool operator() (const vertex_queue_entry_t& i, const vertex_queue_entry_t& j) const {return i.first > j.first;}
+        };
+
+        struct compareEdges {
+            bool operator() (const edge_t& i, const edge_t& j) const {return i.key > j.key;}
+        };
+
+        int batchSize;
+
+        bool batchActive;
+
+        double radius;
+
+        std::list<State*> listSamples;
+        int numSamples;
+        KdTree *kdtreeSamples;
+
+        std::priority_queue<vertex_queue_entry_t, std::vector<vertex_queue_entry_t>, compareVertexQueueEntries> vertexQueue;
+        std::priority_queue<edge_t, std::vector<edge_t>, compareEdges> edgeQueue;
+
+        std::set<vertex_t*> verticesExpanded;
+
+        double evaluateCostToCome (State& stateIn);
+        double evaluateCostToGo (State& stateIn);
+
+        int clearQueues ();
+        int pruneSamples ();
+        int startBatch ();
+        int expandVertex (vertex_t& vertexIn);
+        int processEdge (edge_t& edgeIn, bool& edgeCheckedOut);
+
+    public:
+
+        /*!
+         * \brief BatchPlanner constructor
+         *
+         * More elaborate description
+         */
+        BatchPlanner ();
+
+        /*!
+         * \brief BatchPlanner destructor
+         *
+         * More elaborate description
+         */
+        ~BatchPlanner ();
+
+        /*!
+         * \brief Sets the number of samples drawn in each batch
+         *
+         * More elaborate description
+         *
+         * \param batchSizeIn The new number of samples per batch
+         *
+         */
+        int setBatchSize (int batchSizeIn);
+
+        /*!
+         * \brief Sets the dynamical system used in the trajectory generation
+         *
+         * More elaborate description
+         *
+         * \param system A reference to the new dynamical system
+         *
+         */
+        int setSystem (System& system);
+
+        /*!
+         * \brief Initializes the planner
+         *
+         * Keeps the root vertex and discards all other vertices and samples.
+         */
+        int initialize ();
+
+        /*!
+         * \brief Repairs the tree after the obstacles of the system changed
+         *
+         * Discards the queues of the current batch, see Planner::updateObstacles.
+         */
+        int updateObstacles ();
+
+        /*!
+         * \brief Processes the queued edges up to the first one that is checked for collision
+         *
+         * Starts a new batch of samples when the current batch is exhausted,
+         * i.e., when no queued edge can improve the current solution.
+         */
+        int iteration ();
+
+        /*!
+         * \brief Returns the number of unconnected samples
+         *
+         * More elaborate description
+         */
+        int getNumSamples () {return numSamples;}
+    };
+
+}
+
+#endif
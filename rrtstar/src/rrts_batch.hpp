@@ -0,0 +1,478 @@
+/*!
+ * \file rrts_batch.hpp
+ */
+
+#ifndef __RRTS_BATCH_HPP_
+#define __RRTS_BATCH_HPP_
+
+#include <cfloat>
+#include <cmath>
+
+
+#include "rrts.hpp"
+#include "rrts_batch.h"
+
+
+
+template<class State, class Trajectory, class System>
+RRTstar::BatchPlanner<State, Trajectory, System>
+::BatchPlanner () {
+
+    batchSize = 100;
+    batchActive = false;
+
+    radius = 0.0;
+
+    numSamples = 0;
+    kdtreeSamples = NULL;
+}
+
+
+template<class State, class Trajectory, class System>
+RRTstar::BatchPlanner<State, Trajectory, System>
+::~BatchPlanner () {
+
+    // Delete the kdtree of the samples
+    if (kdtreeSamples) {
+        kd_clear (kdtreeSamples);
+        kd_free (kdtreeSamples);
+    }
+
+    // Delete all the unconnected samples
+    for (typename std::list<State*>::iterator iter = listSamples.begin(); iter != listSamples.end(); iter++)
+        if (*iter)
+            delete *iter;
+}
+
+
+template<class State, class Trajectory, class System>
+int
+RRTstar::BatchPlanner<State, Trajectory, System>
+::setBatchSize (int batchSizeIn) {
+
+    if (batchSizeIn <= 0)
+        return 0;
+
+    batchSize = batchSizeIn;
+
+    return 1;
+}
+
+
+template<class State, class Trajectory, class System>
+int
+RRTstar::BatchPlanner<State, Trajectory, System>
+::setSystem (System& systemIn) {
+
+    clearQueues ();
+    verticesExpanded.clear();
+
+    planner_t::setSystem (systemIn);
+
+    return 1;
+}
+
+
+template<class State, class Trajectory, class System>
+int
+RRTstar::BatchPlanner<State, Trajectory, System>
+::initialize () {
+
+    // The queues hold pointers to vertices that are about to be deleted
+    clearQueues ();
+    verticesExpanded.clear();
+
+    // Delete all the unconnected samples
+    for (typename std::list<State*>::iterator iter = listSamples.begin(); iter != listSamples.end(); iter++)
+        if (*iter)
+            delete *iter;
+    listSamples.clear();
+    numSamples = 0;
+
+    if (kdtreeSamples) {
+        kd_clear (kdtreeSamples);
+        kd_free (kdtreeSamples);
+        kdtreeSamples = NULL;
+    }
+
+    return planner_t::initialize ();
+}
+
+
+template<class State, class Trajectory, class System>
+int
+RRTstar::BatchPlanner<State, Trajectory, System>
+::updateObstacles () {
+
+    // The queues may hold pointers to vertices that are about to be deleted
+    clearQueues ();
+    verticesExpanded.clear();
+
+    return planner_t::updateObstacles ();
+}
+
+
+template<class State, class Trajectory, class System>
+double
+RRTstar::BatchPlanner<State, Trajectory, System>
+::evaluateCostToCome (State& stateIn) {
+
+    bool exactConnection = false;
+    return this->system->evaluateExtensionCost (this->root->getState(), stateIn, exactConnection);
+}
+
+
+template<class State, class Trajectory, class System>
+double
+RRTstar::BatchPlanner<State, Trajectory, System>
+::evaluateCostToGo (State& stateIn) {
+
+    double costToGo = this->system->evaluateCostToGo (stateIn);
+    if (costToGo < 0.0)
+        return 0.0;
+
+    return costToGo;
+}
+
+
+template<class State, class Trajectory, class System>
+int
+RRTstar::BatchPlanner<State, Trajectory, System>
+::clearQueues () {
+
+    while (!vertexQueue.empty())
+        vertexQueue.pop();
+    while (!edgeQueue.empty())
+        edgeQueue.pop();
+    batchActive = false;
+
+    return 1;
+}
+
+
+template<class State, class Trajectory, class System>
+int
+RRTstar::BatchPlanner<State, Trajectory, System>
+::pruneSamples () {
+
+    // Remove the samples that were connected to the tree and the samples
+    //   that can not improve the current solution
+    typename std::list<State*>::iterator iter = listSamples.begin();
+    while (iter != listSamples.end()) {
+
+        State *sampleCurr = *iter;
+        if ( (sampleCurr == NULL) ||
+             (evaluateCostToCome(*sampleCurr) + evaluateCostToGo(*sampleCurr) >= this->lowerBoundCost) ) {
+            if (sampleCurr)
+                delete sampleCurr;
+            iter = listSamples.erase (iter);
+            numSamples--;
+        }
+        else
+            iter++;
+    }
+
+    return 1;
+}
+
+
+template<class State, class Trajectory, class System>
+int
+RRTstar::BatchPlanner<State, Trajectory, System>
+::startBatch () {
+
+    clearQueues ();
+    pruneSamples ();
+
+    // Draw a new batch of collision-free samples from the informed set
+    int numAttempts = 0;
+    int numNewSamples = 0;
+    while ( (numNewSamples < batchSize) && (numAttempts < 10*batchSize) ) {
+
+        numAttempts++;
+
+        State *stateRandom = new State;
+        if (this->drawSample (*stateRandom) <= 0) {
+            delete stateRandom;
+            continue;
+        }
+
+        if (evaluateCostToCome(*stateRandom) + evaluateCostToGo(*stateRandom) >= this->lowerBoundCost) {
+            delete stateRandom;
+            continue;
+        }
+
+        listSamples.push_back (stateRandom);
+        numSamples++;
+        numNewSamples++;
+    }
+
+    // Rebuild the kdtree of the samples
+    if (kdtreeSamples) {
+        kd_clear (kdtreeSamples);
+        kd_free (kdtreeSamples);
+    }
+    kdtreeSamples = kd_create (this->numDimensions);
+
+    double *stateKey = new double[this->numDimensions];
+    for (typename std::list<State*>::iterator iter = listSamples.begin(); iter != listSamples.end(); iter++) {
+        this->system->getStateKey (**iter, stateKey);
+        kd_insert (kdtreeSamples, stateKey, &(*iter));
+    }
+    delete [] stateKey;
+
+    // Compute the connection radius for the implicit graph of this batch
+    double numStates = (double)(this->numVertices + numSamples + 1.0);
+    radius = this->gamma * pow( log(numStates)/numStates, 1.0/((double)this->numDimensions) );
+
+    // Queue the edges from the tree to the samples. This is equivalent to expanding
+    //   every vertex towards the samples, but takes one query per sample.
+    double maxExtensionLength = this->system->getMaxExtensionLength ();
+    stateKey = new double[this->numDimensions];
+    for (typename std::list<State*>::iterator iter = listSamples.begin(); iter != listSamples.end(); iter++) {
+
+        State &stateSample = **iter;
+        double costToGo = evaluateCostToGo (stateSample);
+
+        this->system->getStateKey (stateSample, stateKey);
+        KdRes *kdres = kd_nearest_range (this->kdtree, stateKey, radius);
+        kd_res_rewind (kdres);
+        while (!kd_res_end(kdres)) {
+
+            vertex_t *vertexCurr = (vertex_t *) kd_res_item_data (kdres);
+            kd_res_next (kdres);
+
+            // The vertices that were never expanded are queued for a full expansion below
+            if (verticesExpanded.find(vertexCurr) == verticesExpanded.end())
+                continue;
+
+            bool exactConnection = false;
+            double costEdge = this->system->evaluateExtensionCost (vertexCurr->getState(), stateSample, exactConnection);
+            if (costEdge > maxExtensionLength)
+                continue;
+            if (evaluateCostToCome(vertexCurr->getState()) + costEdge + costToGo >= this->lowerBoundCost)
+                continue;
+
+            edge_t edge;
+            edge.key = vertexCurr->costFromRoot + costEdge + costToGo;
+            edge.vertexFrom = vertexCurr;
+            edge.vertexTo = NULL;
+            edge.sampleTo = &(*iter);
+            edgeQueue.push (edge);
+        }
+        kd_res_free (kdres);
+    }
+    delete [] stateKey;
+
+    // Queue the vertices that were never expanded
+    for (typename std::list<vertex_t*>::iterator iter = this->listVertices.begin(); iter != this->listVertices.end(); iter++) {
+
+        vertex_t *vertexCurr = *iter;
+        if (verticesExpanded.find(vertexCurr) != verticesExpanded.end())
+            continue;
+
+        double key = vertexCurr->costFromRoot + evaluateCostToGo(vertexCurr->getState());
+        if (key < this->lowerBoundCost)
+            vertexQueue.push (vertex_queue_entry_t(key, vertexCurr));
+    }
+
+    batchActive = true;
+
+    return 1;
+}
+
+
+template<class State, class Trajectory, class System>
+int
+RRTstar::BatchPlanner<State, Trajectory, System>
+::expandVertex (Vertex<State,Trajectory,System>& vertexIn) {
+
+    State &stateVertex = vertexIn.getState();
+    double costToComeVertex = evaluateCostToCome (stateVertex);
+    double maxExtensionLength = this->system->getMaxExtensionLength ();
+
+    double *stateKey = new double[this->numDimensions];
+    this->system->getStateKey (stateVertex, stateKey);
+
+    // Queue the edges to the near unconnected samples
+    KdRes *kdres = kd_nearest_range (kdtreeSamples, stateKey, radius);
+    kd_res_rewind (kdres);
+    while (!kd_res_end(kdres)) {
+
+        State **sampleCurr = (State **) kd_res_item_data (kdres);
+        kd_res_next (kdres);
+
+        if (*sampleCurr == NULL)
+            continue;
+
+        bool exactConnection = false;
+        double costEdge = this->system->evaluateExtensionCost (stateVertex, **sampleCurr, exactConnection);
+        if (costEdge > maxExtensionLength)
+            continue;
+        double costToGo = evaluateCostToGo (**sampleCurr);
+        if (costToComeVertex + costEdge + costToGo >= this->lowerBoundCost)
+            continue;
+
+        edge_t edge;
+        edge.key = vertexIn.costFromRoot + costEdge + costToGo;
+        edge.vertexFrom = &vertexIn;
+        edge.vertexTo = NULL;
+        edge.sampleTo = sampleCurr;
+        edgeQueue.push (edge);
+    }
+    kd_res_free (kdres);
+
+    // Queue the rewiring edges to the near vertices, only on the first expansion
+    if (verticesExpanded.find(&vertexIn) == verticesExpanded.end()) {
+
+        verticesExpanded.insert (&vertexIn);
+
+        kdres = kd_nearest_range (this->kdtree, stateKey, radius);
+        kd_res_rewind (kdres);
+        while (!kd_res_end(kdres)) {
+
+            vertex_t *vertexCurr = (vertex_t *) kd_res_item_data (kdres);
+            kd_res_next (kdres);
+
+            if ( (vertexCurr == &vertexIn) || (vertexCurr == vertexIn.parent) || (vertexCurr->parent == &vertexIn) )
+                continue;
+
+            bool exactConnection = false;
+            double costEdge = this->system->evaluateExtensionCost (stateVertex, vertexCurr->getState(), exactConnection);
+            if ( (exactConnection == false) || (costEdge > maxExtensionLength) )
+                continue;
+            if (vertexIn.costFromRoot + costEdge >= vertexCurr->costFromRoot)
+                continue;
+
+            double costToGo = evaluateCostToGo (vertexCurr->getState());
+            if (costToComeVertex + costEdge + costToGo >= this->lowerBoundCost)
+                continue;
+
+            edge_t edge;
+            edge.key = vertexIn.costFromRoot + costEdge + costToGo;
+            edge.vertexFrom = &vertexIn;
+            edge.vertexTo = vertexCurr;
+            edge.sampleTo = NULL;
+            edgeQueue.push (edge);
+        }
+        kd_res_free (kdres);
+    }
+
+    delete [] stateKey;
+
+    return 1;
+}
+
+
+template<class State, class Trajectory, class System>
+int
+RRTstar::BatchPlanner<State, Trajectory, System>
+::processEdge (edge_t& edgeIn, bool& edgeCheckedOut) {
+
+    vertex_t &vertexFrom = *(edgeIn.vertexFrom);
+
+    edgeCheckedOut = false;
+
+    // Skip the edges to samples that were connected through another edge
+    if ( (edgeIn.sampleTo != NULL) && (*(edgeIn.sampleTo) == NULL) )
+        return 0;
+
+    State &stateTo = (edgeIn.vertexTo) ? edgeIn.vertexTo->getState() : **(edgeIn.sampleTo);
+    double costFromRootTo = (edgeIn.vertexTo) ? edgeIn.vertexTo->costFromRoot : DBL_MAX;
+
+    // Recompute the heuristic estimates with the current cost of the tree
+    bool exactConnection = false;
+    double costEdgeEstimate = this->system->evaluateExtensionCost (vertexFrom.getState(), stateTo, exactConnection);
+    if (costEdgeEstimate > this->system->getMaxExtensionLength ())
+        return 0;
+    double costToGo = evaluateCostToGo (stateTo);
+    if (evaluateCostToCome(vertexFrom.getState()) + costEdgeEstimate + costToGo >= this->lowerBoundCost)
+        return 0;
+    if (vertexFrom.costFromRoot + costEdgeEstimate >= costFromRootTo)
+        return 0;
+
+    // Only now check the edge for collisions
+    edgeCheckedOut = true;
+    Trajectory trajectory;
+    exactConnection = false;
+    if (this->system->extendTo (vertexFrom.getState(), stateTo, trajectory, exactConnection) <= 0)
+        return 0;
+    if (exactConnection == false)
+        return 0;
+
+    double costEdge = trajectory.evaluateCost();
+    if (evaluateCostToCome(vertexFrom.getState()) + costEdge + costToGo >= this->lowerBoundCost)
+        return 0;
+    if (vertexFrom.costFromRoot + costEdge >= costFromRootTo)
+        return 0;
+
+    if (edgeIn.vertexTo) {
+
+        // Rewire the vertex and update the cost of its branch
+        this->insertTrajectory (vertexFrom, std::move (trajectory), *(edgeIn.vertexTo));
+        this->updateBranchCost (*(edgeIn.vertexTo), 0);
+        this->updateBestVertex ();
+    }
+    else {
+
+        // Turn the sample into a new vertex, the vertex takes over the sample state
+        vertex_t *vertexNew = new vertex_t;
+        vertexNew->state = *(edgeIn.sampleTo);
+        vertexNew->parent = NULL;
+        *(edgeIn.sampleTo) = NULL;
+
+        this->insertIntoKdtree (*vertexNew);
+        this->listVertices.push_front (vertexNew);
+        this->numVertices++;
+
+        this->insertTrajectory (vertexFrom, std::move (trajectory), *vertexNew);
+
+        vertexQueue.push (vertex_queue_entry_t(vertexNew->costFromRoot + costToGo, vertexNew));
+    }
+
+    return 1;
+}
+
+
+template<class State, class Trajectory, class System>
+int
+RRTstar::BatchPlanner<State, Trajectory, System>
+::iteration () {
+
+    if (!batchActive)
+        startBatch ();
+
+    // Skip the queued edges that turned out not to need a collision check
+    bool edgeChecked = false;
+    while (!edgeChecked) {
+
+        // 1. Expand the vertices that may lead to better edges than the best queued edge
+        while ( !vertexQueue.empty() &&
+                ( edgeQueue.empty() || (vertexQueue.top().first <= edgeQueue.top().key) ) ) {
+
+            vertex_queue_entry_t entry = vertexQueue.top();
+            vertexQueue.pop();
+
+            if (entry.first < this->lowerBoundCost)
+                expandVertex (*(entry.second));
+        }
+
+        // 2. Finish the batch if no queued edge can improve the solution
+        if ( edgeQueue.empty() || (edgeQueue.top().key >= this->lowerBoundCost) ) {
+            clearQueues ();
+            return 0;
+        }
+
+        // 3. Process the best edge
+        edge_t edge = edgeQueue.top();
+        edgeQueue.pop();
+
+        if (processEdge (edge, edgeChecked) > 0)
+            return 1;
+    }
+
+    return 0;
+}
+
+
+#endif
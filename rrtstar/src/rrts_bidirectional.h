@@ -0,0 +1,146 @@
+/*!
+ * \file rrts_bidirectional.h
+ */
+
+#ifndef __RRTS_BIDIRECTIONAL_H_
+#define __RRTS_BIDIRECTIONAL_H_
+
+
+#include "rrts.h"
+
+#include <list>
+#include <map>
+#include <vector>
+
+
+
+namespace RRTstar {
+
+
+    /*!
+     * \brief Bidirectional RRT* planner class
+     *
+     * Grows one RRT* tree from the root and a second one from a state in the
+     * goal region, alternating between the two trees. Every new vertex is
+     * connected to the near vertices of the other tree. A connection is
+     * grafted onto the root tree, so the best vertex and the best trajectory
+     * are reported exactly as in Planner. Each goal tree vertex is copied
+     * into the root tree at most once, later connections rewire the copy.
+     *
+     * The goal tree is grown backwards: the edge of each of its vertices is
+     * the trajectory from the vertex to its parent, and its cost is the cost
+     * to reach the goal root. Only System::extendTo in the forward direction
+     * is used, so the system does not need to be reversible. When the system
+     * does not store trajectories (SystemTraits), the edges of a grafted
+     * branch are generated again with System::extendTo.
+     */
+    template<class State, class Trajectory, class System>
+    class BidirectionalPlanner : public Planner<State,Trajectory,System> {
+
+        typedef struct kdtree KdTree;
+        typedef struct kdres KdRes;
+        typedef Vertex<State,Trajectory,System> vertex_t;
+        typedef Planner<State,Trajectory,System> planner_t;
+
+        KdTree *kdtreeGoal;
+
+        vertex_t *rootGoal;
+
+        bool extendGoalTreeNext;
+
+        // The copies of the goal tree vertices grafted onto the root tree
+        std::map<vertex_t*, vertex_t*> verticesGrafted;
+
+        int clearGoalTree ();
+        int initializeGoalTree ();
+
+        int insertIntoGoalKdtree (vertex_t &vertexIn);
+        int getNearGoalVertices (State& stateIn, std::vector<vertex_t*>& vectorNearVerticesOut);
+
+        int insertGoalTrajectory (vertex_t& vertexStartIn, Trajectory&& trajectoryIn, vertex_t& vertexEndIn);
+        int findBestGoalParent (State& stateIn, std::vector<vertex_t*>& vectorNearVerticesIn,
+                                vertex_t*& vertexBestOut, Trajectory& trajectoryOut);
+        int updateGoalBranchCost (vertex_t& vertexIn, int depth);
+        int rewireGoalVertices (vertex_t& vertexNew, std::vector<vertex_t*>& vectorNearVertices);
+        int extendGoalTree (State& stateIn, vertex_t*& vertexNewOut);
+
+        int connectToGoalTree (vertex_t& vertexIn);
+        int connectToRootTree (vertex_t& vertexIn);
+        int graftGoalBranch (vertex_t& vertexStartIn, Trajectory&& trajectoryIn, vertex_t& vertexGoalIn);
+
+    public:
+
+        /*!
+         * \brief A list of all the vertices of the goal tree
+         *
+         * More elaborate description
+         */
+        std::list<vertex_t*> listVerticesGoal;
+
+        /*!
+         * \brief Number of vertices in the goal tree
+         *
+         * More elaborate description
+         */
+        int numVerticesGoal;
+
+        /*!
+         * \brief BidirectionalPlanner constructor
+         *
+         * More elaborate description
+         */
+        BidirectionalPlanner ();
+
+        /*!
+         * \brief BidirectionalPlanner destructor
+         *
+         * More elaborate description
+         */
+        ~BidirectionalPlanner ();
+
+        /*!
+         * \brief Sets the dynamical system used in the trajectory generation
+         *
+         * More elaborate description
+         *
+         * \param system A reference to the new dynamical system
+         *
+         */
+        int setSystem (System& system);
+
+        /*!
+         * \brief Returns a reference to the root vertex of the goal tree
+         *
+         * More elaborate description
+         */
+        vertex_t& getGoalRootVertex () {return *rootGoal;}
+
+        /*!
+         * \brief Initializes both trees
+         *
+         * The root of the goal tree is sampled from the goal region with
+         * System::sampleGoalState.
+         */
+        int initialize ();
+
+        /*!
+         * \brief Repairs the root tree after the obstacles of the system changed
+         *
+         * The root tree is repaired as in Planner::updateObstacles. The goal
+         * tree is grown again from a new goal root, since its edges are
+         * grafted onto the root tree without further checks.
+         */
+        int updateObstacles ();
+
+        /*!
+         * \brief Extends one of the two trees and tries to connect the new
+         *        vertex to the other tree
+         *
+         * More elaborate description
+         */
+        int iteration ();
+    };
+
+}
+
+#endif
@@ -0,0 +1,516 @@
+/*!
+ * \file rrts_bidirectional.hpp
+ */
+
+#ifndef __RRTS_BIDIRECTIONAL_HPP_
+#define __RRTS_BIDIRECTIONAL_HPP_
+
+#include <cfloat>
+#include <cmath>
+#include <algorithm>
+
+
+#include "rrts.hpp"
+#include "rrts_bidirectional.h"
+
+
+
+template<class State, class Trajectory, class System>
+RRTstar::BidirectionalPlanner<State, Trajectory, System>
+::BidirectionalPlanner () {
+
+    kdtreeGoal = NULL;
+
+    rootGoal = NULL;
+
+    numVerticesGoal = 0;
+
+    extendGoalTreeNext = false;
+}
+
+
+template<class State, class Trajectory, class System>
+RRTstar::BidirectionalPlanner<State, Trajectory, System>
+::~BidirectionalPlanner () {
+
+    clearGoalTree ();
+}
+
+
+template<class State, class Trajectory, class System>
+int
+RRTstar::BidirectionalPlanner<State, Trajectory, System>
+::clearGoalTree () {
+
+    // Delete the kdtree structure
+    if (kdtreeGoal) {
+        kd_clear (kdtreeGoal);
+        kd_free (kdtreeGoal);
+        kdtreeGoal = NULL;
+    }
+
+    // Delete all the vertices
+    for (typename std::list<vertex_t*>::iterator iter = listVerticesGoal.begin(); iter != listVerticesGoal.end(); iter++)
+        delete *iter;
+    listVerticesGoal.clear();
+    numVerticesGoal = 0;
+    rootGoal = NULL;
+    verticesGrafted.clear();
+
+    return 1;
+}
+
+
+template<class State, class Trajectory, class System>
+int
+RRTstar::BidirectionalPlanner<State, Trajectory, System>
+::setSystem (System& systemIn) {
+
+    clearGoalTree ();
+
+    return planner_t::setSystem (systemIn);
+}
+
+
+template<class State, class Trajectory, class System>
+int
+RRTstar::BidirectionalPlanner<State, Trajectory, System>
+::initialize () {
+
+    if (planner_t::initialize () <= 0)
+        return 0;
+
+    return initializeGoalTree ();
+}
+
+
+template<class State, class Trajectory, class System>
+int
+RRTstar::BidirectionalPlanner<State, Trajectory, System>
+::initializeGoalTree () {
+
+    clearGoalTree ();
+    kdtreeGoal = kd_create (this->numDimensions);
+
+    // Sample a collision-free root for the goal tree
+    State *stateGoal = new State;
+    int numAttempts = 0;
+    while (this->system->sampleGoalState (*stateGoal, this->sampler) <= 0) {
+        numAttempts++;
+        if (numAttempts >= 1000) {
+            delete stateGoal;
+            return 0;
+        }
+    }
+
+    rootGoal = new vertex_t;
+    rootGoal->state = stateGoal;
+    rootGoal->costFromParent = 0.0;
+    rootGoal->costFromRoot = 0.0;
+    rootGoal->trajFromParent = NULL;
+
+    listVerticesGoal.push_back (rootGoal);
+    insertIntoGoalKdtree (*rootGoal);
+    numVerticesGoal++;
+
+    extendGoalTreeNext = false;
+
+    return 1;
+}
+
+
+template<class State, class Trajectory, class System>
+int
+RRTstar::BidirectionalPlanner<State, Trajectory, System>
+::updateObstacles () {
+
+    if (planner_t::updateObstacles () <= 0)
+        return 0;
+
+    return initializeGoalTree ();
+}
+
+
+template<class State, class Trajectory, class System>
+int
+RRTstar::BidirectionalPlanner<State, Trajectory, System>
+::insertIntoGoalKdtree (Vertex<State,Trajectory,System>& vertexIn) {
+
+    double *stateKey = new double[this->numDimensions];
+    this->system->getStateKey ( *(vertexIn.state), stateKey);
+    kd_insert (kdtreeGoal, stateKey, &vertexIn);
+    delete [] stateKey;
+
+    return 1;
+}
+
+
+template<class State, class Trajectory, class System>
+int
+RRTstar::BidirectionalPlanner<State, Trajectory, System>
+::getNearGoalVertices (State& stateIn, std::vector< Vertex<State,Trajectory,System>* >& vectorNearVerticesOut) {
+
+    vectorNearVerticesOut.clear();
+
+    // Get the state key for the query state
+    double *stateKey = new double[this->numDimensions];
+    this->system->getStateKey (stateIn, stateKey);
+
+    // Compute the ball radius
+    double ballRadius = this->gamma * pow( log((double)(numVerticesGoal + 1.0))/((double)(numVerticesGoal + 1.0)), 1.0/((double)this->numDimensions) );
+
+    // Search the kdtree for the set of near vertices, leaving out the vertices
+    //   farther than the maximum extension length
+    double maxExtensionLength = this->system->getMaxExtensionLength ();
+    KdRes *kdres = kd_nearest_range (kdtreeGoal, stateKey, ballRadius);
+    kd_res_rewind (kdres);
+    while (!kd_res_end(kdres)) {
+        vertex_t *vertexCurr = (vertex_t *) kd_res_item_data (kdres);
+        bool exactConnection = false;
+        if ( (maxExtensionLength == HUGE_VAL)
+             || (this->system->evaluateExtensionCost (stateIn, *(vertexCurr->state), exactConnection) <= maxExtensionLength) )
+            vectorNearVerticesOut.push_back (vertexCurr);
+        kd_res_next (kdres);
+    }
+    kd_res_free (kdres);
+
+    // Use the nearest vertex if the set is empty
+    if (vectorNearVerticesOut.empty()) {
+        kdres = kd_nearest (kdtreeGoal, stateKey);
+        if (!kd_res_end (kdres))
+            vectorNearVerticesOut.push_back ((vertex_t *) kd_res_item_data (kdres));
+        kd_res_free (kdres);
+    }
+    delete [] stateKey;
+
+    return 1;
+}
+
+
+template<class State, class Trajectory, class System>
+int
+RRTstar::BidirectionalPlanner<State, Trajectory, System>
+::insertGoalTrajectory (Vertex<State,Trajectory,System>& vertexStartIn, Trajectory&& trajectoryIn, Vertex<State,Trajectory,System>& vertexEndIn) {
+
+    // In the goal tree, the trajectory leads from the end vertex to the start vertex
+    vertexEndIn.costFromParent = trajectoryIn.evaluateCost();
+    vertexEndIn.costFromRoot = vertexStartIn.costFromRoot + vertexEndIn.costFromParent;
+
+    if (vertexEndIn.trajFromParent)
+        delete vertexEndIn.trajFromParent;
+    vertexEndIn.trajFromParent = NULL;
+    if (SystemTraits<System>::storeTrajectories)
+        vertexEndIn.trajFromParent = new Trajectory (std::move (trajectoryIn));
+
+    if (vertexEndIn.parent)
+        vertexEndIn.parent->children.erase (&vertexEndIn);
+    vertexEndIn.parent = &vertexStartIn;
+
+    vertexStartIn.children.insert (&vertexEndIn);
+
+    return 1;
+}
+
+
+template<class State, class Trajectory, class System>
+int
+RRTstar::BidirectionalPlanner<State, Trajectory, System>
+::findBestGoalParent (State& stateIn, std::vector< Vertex<State,Trajectory,System>* >& vectorNearVerticesIn,
+                      Vertex<State,Trajectory,System>*& vertexBestOut, Trajectory& trajectoryOut) {
+
+    // Compute the cost of reaching the goal root through each near vertex
+    std::vector< std::pair<vertex_t*,double> > vectorVertexCostPairs (vectorNearVerticesIn.size());
+
+    int i = 0;
+    for (typename std::vector<vertex_t*>::iterator iter = vectorNearVerticesIn.begin(); iter != vectorNearVerticesIn.end(); iter++) {
+
+        bool exactConnection = false;
+        vectorVertexCostPairs[i].first = *iter;
+        vectorVertexCostPairs[i].second = (*iter)->costFromRoot + this->system->evaluateExtensionCost (stateIn, *((*iter)->state), exactConnection);
+        i++;
+    }
+
+    // Sort vertices according to cost
+    std::sort (vectorVertexCostPairs.begin(), vectorVertexCostPairs.end(), compareVertexCostPairs<State,Trajectory,System>);
+
+    // Try out each extension according to increasing cost
+    for (typename std::vector< std::pair<vertex_t*,double> >::iterator iter = vectorVertexCostPairs.begin();
+         iter != vectorVertexCostPairs.end(); iter++) {
+
+        bool exactConnection = false;
+        if ( (this->system->extendTo (stateIn, *(iter->first->state), trajectoryOut, exactConnection) > 0) && exactConnection ) {
+            vertexBestOut = iter->first;
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+
+template<class State, class Trajectory, class System>
+int
+RRTstar::BidirectionalPlanner<State, Trajectory, System>
+::updateGoalBranchCost (Vertex<State,Trajectory,System>& vertexIn, int depth) {
+
+    for (typename std::set<vertex_t*>::iterator iter = vertexIn.children.begin(); iter != vertexIn.children.end(); iter++) {
+
+        vertex_t& vertex = **iter;
+
+        vertex.costFromRoot = vertexIn.costFromRoot + vertex.costFromParent;
+
+        updateGoalBranchCost (vertex, depth + 1);
+    }
+
+    return 1;
+}
+
+
+template<class State, class Trajectory, class System>
+int
+RRTstar::BidirectionalPlanner<State, Trajectory, System>
+::rewireGoalVertices (Vertex<State,Trajectory,System>& vertexNew, std::vector< Vertex<State,Trajectory,System>* >& vectorNearVertices) {
+
+    for (typename std::vector<vertex_t*>::iterator iter = vectorNearVertices.begin(); iter != vectorNearVertices.end(); iter++) {
+
+        vertex_t& vertexCurr = **iter;
+
+        // Check whether reaching the goal root through the new vertex is cheaper
+        bool exactConnection = false;
+        double costCurr = this->system->evaluateExtensionCost (*(vertexCurr.state), *(vertexNew.state), exactConnection);
+        if ( (exactConnection == false) || (costCurr < 0) )
+            continue;
+
+        if (vertexNew.costFromRoot + costCurr < vertexCurr.costFromRoot - 0.001) {
+
+            Trajectory trajectory;
+            if (this->system->extendTo (*(vertexCurr.state), *(vertexNew.state), trajectory, exactConnection) <= 0)
+                continue;
+
+            insertGoalTrajectory (vertexNew, std::move (trajectory), vertexCurr);
+
+            updateGoalBranchCost (vertexCurr, 0);
+        }
+    }
+
+    return 1;
+}
+
+
+template<class State, class Trajectory, class System>
+int
+RRTstar::BidirectionalPlanner<State, Trajectory, System>
+::extendGoalTree (State& stateIn, Vertex<State,Trajectory,System>*& vertexNewOut) {
+
+    vertexNewOut = NULL;
+
+    std::vector<vertex_t*> vectorNearVertices;
+    getNearGoalVertices (stateIn, vectorNearVertices);
+    if (vectorNearVertices.empty())
+        return 0;
+
+    // The near vertices are within the maximum extension length, unless the only
+    //   one is the nearest vertex. Steer towards it and search again in that case.
+    if (this->system->getMaxExtensionLength () < HUGE_VAL) {
+        bool exactConnection = false;
+        vertex_t *vertexNearest = vectorNearVertices.front();
+        if (this->system->evaluateExtensionCost (stateIn, vertexNearest->getState(), exactConnection) > this->system->getMaxExtensionLength ()) {
+            this->system->steerState (vertexNearest->getState(), stateIn);
+            getNearGoalVertices (stateIn, vectorNearVertices);
+        }
+    }
+
+    vertex_t *vertexParent = NULL;
+    Trajectory trajectory;
+    if (findBestGoalParent (stateIn, vectorNearVertices, vertexParent, trajectory) <= 0)
+        return 0;
+
+    // Create the new vertex
+    vertex_t *vertexNew = new vertex_t;
+    vertexNew->state = new State (stateIn);
+    vertexNew->parent = NULL;
+    insertIntoGoalKdtree (*vertexNew);
+    listVerticesGoal.push_front (vertexNew);
+    numVerticesGoal++;
+
+    insertGoalTrajectory (*vertexParent, std::move (trajectory), *vertexNew);
+
+    rewireGoalVertices (*vertexNew, vectorNearVertices);
+
+    vertexNewOut = vertexNew;
+
+    return 1;
+}
+
+
+template<class State, class Trajectory, class System>
+int
+RRTstar::BidirectionalPlanner<State, Trajectory, System>
+::graftGoalBranch (Vertex<State,Trajectory,System>& vertexStartIn, Trajectory&& trajectoryIn, Vertex<State,Trajectory,System>& vertexGoalIn) {
+
+    // Copy the goal branch into the root tree. A goal vertex that was grafted
+    //   before keeps its copy, which is rewired if the new branch reaches it cheaper.
+    bool rewired = false;
+    vertex_t *vertexPrev = &vertexStartIn;
+    vertex_t *vertexGoalCurr = &vertexGoalIn;
+    Trajectory trajectory (std::move (trajectoryIn));
+    while (true) {
+
+        typename std::map<vertex_t*,vertex_t*>::iterator iterGrafted = verticesGrafted.find (vertexGoalCurr);
+        vertex_t *vertexCopy = NULL;
+        if (iterGrafted == verticesGrafted.end()) {
+            vertexCopy = new vertex_t;
+            vertexCopy->state = new State (vertexGoalCurr->getState());
+            vertexCopy->parent = NULL;
+            this->insertIntoKdtree (*vertexCopy);
+            this->listVertices.push_front (vertexCopy);
+            this->numVertices++;
+            this->insertTrajectory (*vertexPrev, std::move (trajectory), *vertexCopy);
+            verticesGrafted[vertexGoalCurr] = vertexCopy;
+        }
+        else {
+            vertexCopy = iterGrafted->second;
+            if (vertexPrev->costFromRoot + trajectory.evaluateCost() < vertexCopy->costFromRoot) {
+                this->insertTrajectory (*vertexPrev, std::move (trajectory), *vertexCopy);
+                this->updateBranchCost (*vertexCopy, 0);
+                rewired = true;
+            }
+        }
+
+        if (vertexGoalCurr->parent == NULL)
+            break;
+
+        // Follow the goal tree down to its root, reusing the stored trajectories if any
+        if (vertexGoalCurr->trajFromParent)
+            trajectory = *(vertexGoalCurr->trajFromParent);
+        else {
+            // Generate the trajectory again, the edge of the goal tree is known to be valid
+            trajectory = Trajectory ();
+            bool exactConnection = false;
+            this->system->extendTo (vertexGoalCurr->getState(), vertexGoalCurr->parent->getState(), trajectory, exactConnection);
+        }
+
+        vertexPrev = vertexCopy;
+        vertexGoalCurr = vertexGoalCurr->parent;
+    }
+
+    // The rewired copies carry their grafted branches along
+    if (rewired)
+        this->updateBestVertex ();
+
+    return 1;
+}
+
+
+template<class State, class Trajectory, class System>
+int
+RRTstar::BidirectionalPlanner<State, Trajectory, System>
+::connectToGoalTree (Vertex<State,Trajectory,System>& vertexIn) {
+
+    std::vector<vertex_t*> vectorNearVertices;
+    getNearGoalVertices (vertexIn.getState(), vectorNearVertices);
+
+    // Sort the connections according to the cost of the resulting solution
+    std::vector< std::pair<vertex_t*,double> > vectorVertexCostPairs (vectorNearVertices.size());
+    for (unsigned int i = 0; i < vectorNearVertices.size(); i++) {
+        bool exactConnection = false;
+        vectorVertexCostPairs[i].first = vectorNearVertices[i];
+        vectorVertexCostPairs[i].second = vertexIn.costFromRoot + vectorNearVertices[i]->costFromRoot
+            + this->system->evaluateExtensionCost (vertexIn.getState(), vectorNearVertices[i]->getState(), exactConnection);
+    }
+    std::sort (vectorVertexCostPairs.begin(), vectorVertexCostPairs.end(), compareVertexCostPairs<State,Trajectory,System>);
+
+    for (typename std::vector< std::pair<vertex_t*,double> >::iterator iter = vectorVertexCostPairs.begin();
+         iter != vectorVertexCostPairs.end(); iter++) {
+
+        if (iter->second >= this->lowerBoundCost)
+            return 0;
+
+        Trajectory trajectory;
+        bool exactConnection = false;
+        if ( (this->system->extendTo (vertexIn.getState(), iter->first->getState(), trajectory, exactConnection) > 0) && exactConnection ) {
+            graftGoalBranch (vertexIn, std::move (trajectory), *(iter->first));
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+
+template<class State, class Trajectory, class System>
+int
+RRTstar::BidirectionalPlanner<State, Trajectory, System>
+::connectToRootTree (Vertex<State,Trajectory,System>& vertexIn) {
+
+    std::vector<vertex_t*> vectorNearVertices;
+    this->getNearVertices (vertexIn.getState(), vectorNearVertices);
+    if (vectorNearVertices.size() == 0) {
+        vertex_t *vertexNearest = NULL;
+        if (this->getNearestVertex (vertexIn.getState(), vertexNearest) <= 0)
+            return 0;
+        vectorNearVertices.push_back (vertexNearest);
+    }
+
+    // Sort the connections according to the cost of the resulting solution
+    std::vector< std::pair<vertex_t*,double> > vectorVertexCostPairs (vectorNearVertices.size());
+    for (unsigned int i = 0; i < vectorNearVertices.size(); i++) {
+        bool exactConnection = false;
+        vectorVertexCostPairs[i].first = vectorNearVertices[i];
+        vectorVertexCostPairs[i].second = vectorNearVertices[i]->costFromRoot + vertexIn.costFromRoot
+            + this->system->evaluateExtensionCost (vectorNearVertices[i]->getState(), vertexIn.getState(), exactConnection);
+    }
+    std::sort (vectorVertexCostPairs.begin(), vectorVertexCostPairs.end(), compareVertexCostPairs<State,Trajectory,System>);
+
+    for (typename std::vector< std::pair<vertex_t*,double> >::iterator iter = vectorVertexCostPairs.begin();
+         iter != vectorVertexCostPairs.end(); iter++) {
+
+        if (iter->second >= this->lowerBoundCost)
+            return 0;
+
+        Trajectory trajectory;
+        bool exactConnection = false;
+        if ( (this->system->extendTo (iter->first->getState(), vertexIn.getState(), trajectory, exactConnection) > 0) && exactConnection ) {
+            graftGoalBranch (*(iter->first), std::move (trajectory), vertexIn);
+            return 1;
+        }
+    }
+
+    return 0;
+}
+
+
+template<class State, class Trajectory, class System>
+int
+RRTstar::BidirectionalPlanner<State, Trajectory, System>
+::iteration () {
+
+    if (rootGoal == NULL)
+        return 0;
+
+    // 1. Sample a new state
+    State stateRandom;
+    if (this->drawSample (stateRandom) <= 0)
+        return 0;
+
+    // 2. Extend one of the trees and try to connect the new vertex to the other tree
+    vertex_t *vertexNew = NULL;
+    bool extendGoalTreeCurr = extendGoalTreeNext;
+    extendGoalTreeNext = !extendGoalTreeNext;
+
+    if (extendGoalTreeCurr) {
+        if (extendGoalTree (stateRandom, vertexNew) <= 0)
+            return 0;
+        connectToRootTree (*vertexNew);
+    }
+    else {
+        if (this->extendTree (stateRandom, vertexNew) <= 0)
+            return 0;
+        connectToGoalTree (*vertexNew);
+    }
+
+    return 1;
+}
+
+
+#endif
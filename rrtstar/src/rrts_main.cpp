@@ -10,6 +10,7 @@
 #include <lcmtypes/lcmtypes.h>
 
 #include "rrts.hpp"
+#include "path_optimizer.hpp"
 #include "system_single_integrator.h"
 
 
@@ -160,6 +161,17 @@ int main () {
      clock_t finish = clock();
     cout << "Time : " << ((double)(finish-start))/CLOCKS_PER_SEC << endl;
     
+    // Shortcut the first path found
+    if (&rrts.getBestVertex() != NULL) {
+        PathOptimizer<State,Trajectory,System> optimizer;
+        optimizer.setSystem (system);
+        optimizer.setPath (rrts.getBestVertex());
+        optimizer.setNumSmoothingIterations (10);
+        optimizer.setTimeBudget (0.05);
+        optimizer.optimize ();
+        cout << "Path cost : " << optimizer.getInitialCost() << " -> " << optimizer.getCost() << endl;
+    }
+    
     publishTree (lcm, rrts, system);
     
     publishTraj (lcm, rrts, system);
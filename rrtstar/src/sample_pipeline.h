@@ -0,0 +1,150 @@
+/*!
+ * \file sample_pipeline.h
+ */
+
+#ifndef __RRTS_SAMPLE_PIPELINE_H_
+#define __RRTS_SAMPLE_PIPELINE_H_
+
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+
+
+namespace RRTstar {
+
+
+    /*!
+     * \brief Draws the samples of a planner in a background thread
+     *
+     * A worker thread calls System::sampleState, which includes the collision
+     * check and the gradient descent of the sample, and keeps the valid
+     * samples in a ring buffer. The planner only takes valid samples out of
+     * the buffer. The worker calls the system concurrently with the planner,
+     * so the system must only be read while the pipeline runs: stop the
+     * pipeline before changing the obstacles or the regions of the system,
+     * and start it again afterwards. The planner draws its goal states with
+     * its own sampler, which leaves the sampler of the system to the worker.
+     */
+    template<class State, class System>
+    class SamplePipeline {
+
+        System *system;
+
+        std::thread worker;
+        bool running;
+        bool stopping;
+
+        // Ring buffer of valid samples
+        std::vector<State> buffer;
+        int bufferHead;
+        int bufferCount;
+
+        std::mutex mutex;
+        std::condition_variable conditionNotEmpty;
+        std::condition_variable conditionNotFull;
+
+        unsigned long numSamplesDrawn;
+        unsigned long numSamplesRejected;
+        unsigned long numSamplesDelivered;
+        unsigned long numStalls;
+        double timeSampling;
+
+        void run ();
+
+    public:
+
+        /*!
+         * \brief SamplePipeline constructor
+         *
+         * More elaborate description
+         */
+        SamplePipeline ();
+
+        /*!
+         * \brief SamplePipeline destructor
+         *
+         * Stops the worker thread.
+         */
+        ~SamplePipeline ();
+
+        /*!
+         * \brief Starts the worker thread
+         *
+         * Empties the buffer and resets the statistics. The first sample is
+         * drawn in the calling thread, which lets the system build its
+         * obstacle indices before the worker starts.
+         *
+         * \param systemIn The system that generates the samples
+         * \param capacityIn The number of samples kept in the buffer
+         *
+         */
+        int start (System& systemIn, int capacityIn);
+
+        /*!
+         * \brief Stops the worker thread and empties the buffer
+         *
+         * More elaborate description
+         */
+        int stop ();
+
+        /*!
+         * \brief Returns true between start and stop
+         *
+         * More elaborate description
+         */
+        bool isRunning () {return running;}
+
+        /*!
+         * \brief Takes the next valid sample out of the buffer
+         *
+         * Waits for the worker if the buffer is empty. Returns 0 if the
+         * pipeline is not running.
+         *
+         * \param stateOut The sample
+         *
+         */
+        int getSample (State& stateOut);
+
+        /*!
+         * \brief Returns the number of calls to System::sampleState since start
+         *
+         * More elaborate description
+         */
+        unsigned long getNumSamplesDrawn ();
+
+        /*!
+         * \brief Returns the number of samples rejected by System::sampleState since start
+         *
+         * More elaborate description
+         */
+        unsigned long getNumSamplesRejected ();
+
+        /*!
+         * \brief Returns the number of samples taken by getSample since start
+         *
+         * More elaborate description
+         */
+        unsigned long getNumSamplesDelivered ();
+
+        /*!
+         * \brief Returns the number of calls to getSample that found the buffer empty
+         *
+         * More elaborate description
+         */
+        unsigned long getNumStalls ();
+
+        /*!
+         * \brief Returns the average time of a call to System::sampleState, in seconds
+         *
+         * This is the cost of drawing, checking and refining a sample that the
+         * pipeline takes off the planning thread. The refinement itself is
+         * counted by the system, see SingleIntegrator::System::getNumRGDSteps.
+         */
+        double getAverageSamplingTime ();
+    };
+}
+
+
+#endif
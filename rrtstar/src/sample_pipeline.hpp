@@ -0,0 +1,230 @@
+/*!
+ * \file sample_pipeline.hpp
+ */
+
+#ifndef __RRTS_SAMPLE_PIPELINE_HPP_
+#define __RRTS_SAMPLE_PIPELINE_HPP_
+
+#include <chrono>
+#include <utility>
+
+
+#include "sample_pipeline.h"
+
+
+
+template<class State, class System>
+RRTstar::SamplePipeline<State, System>
+::SamplePipeline () {
+
+    system = NULL;
+
+    running = false;
+    stopping = false;
+
+    bufferHead = 0;
+    bufferCount = 0;
+
+    numSamplesDrawn = 0;
+    numSamplesRejected = 0;
+    numSamplesDelivered = 0;
+    numStalls = 0;
+    timeSampling = 0.0;
+}
+
+
+template<class State, class System>
+RRTstar::SamplePipeline<State, System>
+::~SamplePipeline () {
+
+    stop ();
+}
+
+
+template<class State, class System>
+int
+RRTstar::SamplePipeline<State, System>
+::start (System& systemIn, int capacityIn) {
+
+    if (capacityIn <= 0)
+        return 0;
+
+    stop ();
+
+    system = &systemIn;
+
+    buffer.clear ();
+    buffer.resize (capacityIn);
+    bufferHead = 0;
+    bufferCount = 0;
+
+    numSamplesDrawn = 0;
+    numSamplesRejected = 0;
+    numSamplesDelivered = 0;
+    numStalls = 0;
+    timeSampling = 0.0;
+
+    // Any lazy initialization of the system happens in this thread
+    numSamplesDrawn++;
+    if (system->sampleState (buffer[0]) > 0)
+        bufferCount = 1;
+    else
+        numSamplesRejected++;
+
+    stopping = false;
+    running = true;
+    worker = std::thread (&SamplePipeline::run, this);
+
+    return 1;
+}
+
+
+template<class State, class System>
+int
+RRTstar::SamplePipeline<State, System>
+::stop () {
+
+    if (!running)
+        return 1;
+
+    {
+        std::lock_guard<std::mutex> lock (mutex);
+        stopping = true;
+    }
+    conditionNotFull.notify_all ();
+    conditionNotEmpty.notify_all ();
+
+    worker.join ();
+    running = false;
+
+    bufferHead = 0;
+    bufferCount = 0;
+
+    return 1;
+}
+
+
+template<class State, class System>
+void
+RRTstar::SamplePipeline<State, System>
+::run () {
+
+    State stateNew;
+    int capacity = buffer.size();
+
+    while (true) {
+
+        // Draw and refine the sample without holding the lock
+        std::chrono::steady_clock::time_point timeStart = std::chrono::steady_clock::now ();
+        int sampleValid = system->sampleState (stateNew);
+        double timeElapsed = std::chrono::duration<double> (std::chrono::steady_clock::now () - timeStart).count ();
+
+        std::unique_lock<std::mutex> lock (mutex);
+
+        numSamplesDrawn++;
+        timeSampling += timeElapsed;
+        if (sampleValid <= 0) {
+            numSamplesRejected++;
+            if (stopping)
+                return;
+            continue;
+        }
+
+        while ( (bufferCount == capacity) && !stopping )
+            conditionNotFull.wait (lock);
+        if (stopping)
+            return;
+
+        buffer[(bufferHead + bufferCount) % capacity] = std::move (stateNew);
+        bufferCount++;
+
+        lock.unlock ();
+        conditionNotEmpty.notify_one ();
+    }
+}
+
+
+template<class State, class System>
+int
+RRTstar::SamplePipeline<State, System>
+::getSample (State& stateOut) {
+
+    if (!running)
+        return 0;
+
+    std::unique_lock<std::mutex> lock (mutex);
+
+    if (bufferCount == 0)
+        numStalls++;
+    while ( (bufferCount == 0) && !stopping )
+        conditionNotEmpty.wait (lock);
+    if (bufferCount == 0)
+        return 0;
+
+    stateOut = std::move (buffer[bufferHead]);
+    bufferHead = (bufferHead + 1) % buffer.size();
+    bufferCount--;
+    numSamplesDelivered++;
+
+    lock.unlock ();
+    conditionNotFull.notify_one ();
+
+    return 1;
+}
+
+
+template<class State, class System>
+unsigned long
+RRTstar::SamplePipeline<State, System>
+::getNumSamplesDrawn () {
+
+    std::lock_guard<std::mutex> lock (mutex);
+    return numSamplesDrawn;
+}
+
+
+template<class State, class System>
+unsigned long
+RRTstar::SamplePipeline<State, System>
+::getNumSamplesRejected () {
+
+    std::lock_guard<std::mutex> lock (mutex);
+    return numSamplesRejected;
+}
+
+
+template<class State, class System>
+unsigned long
+RRTstar::SamplePipeline<State, System>
+::getNumSamplesDelivered () {
+
+    std::lock_guard<std::mutex> lock (mutex);
+    return numSamplesDelivered;
+}
+
+
+template<class State, class System>
+unsigned long
+RRTstar::SamplePipeline<State, System>
+::getNumStalls () {
+
+    std::lock_guard<std::mutex> lock (mutex);
+    return numStalls;
+}
+
+
+template<class State, class System>
+double
+RRTstar::SamplePipeline<State, System>
+::getAverageSamplingTime () {
+
+    std::lock_guard<std::mutex> lock (mutex);
+    if (numSamplesDrawn <= 1)
+        return 0.0;
+
+    // The first sample is drawn by start and not timed
+    return timeSampling/(double)(numSamplesDrawn - 1);
+}
+
+
+#endif
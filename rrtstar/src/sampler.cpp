@@ -0,0 +1,258 @@
+#include "sampler.h"
+#include <cmath>
+
+using namespace std;
+using namespace RRTstar;
+
+#define HALTON_MAX_DIMENSIONS 16
+#define SOBOL_MAX_DIMENSIONS 10
+#define SOBOL_BITS 32
+
+
+static const int haltonBases[HALTON_MAX_DIMENSIONS] = {
+    2, 3, 5, 7, 11, 13, 17, 19, 23, 29, 31, 37, 41, 43, 47, 53
+};
+
+
+// Primitive polynomials and initial direction numbers of dimensions 2 to 10, from
+//   S. Joe and F. Y. Kuo, "Constructing Sobol sequences with better two-dimensional projections"
+static const int sobolDegrees[SOBOL_MAX_DIMENSIONS - 1] = {1, 2, 3, 3, 4, 4, 5, 5, 5};
+static const int sobolCoefficients[SOBOL_MAX_DIMENSIONS - 1] = {0, 1, 1, 2, 1, 4, 2, 4, 7};
+static const uint32_t sobolInitial[SOBOL_MAX_DIMENSIONS - 1][5] = {
+    {1},
+    {1, 3},
+    {1, 3, 1},
+    {1, 1, 1},
+    {1, 1, 3, 3},
+    {1, 3, 5, 13},
+    {1, 1, 5, 5, 17},
+    {1, 1, 5, 5, 5},
+    {1, 1, 7, 11, 19}
+};
+
+
+static inline uint64_t rotl (uint64_t x, int k) {
+
+    return (x << k) | (x >> (64 - k));
+}
+
+
+static inline uint64_t splitmix64 (uint64_t &x) {
+
+    uint64_t z = (x += 0x9e3779b97f4a7c15ULL);
+    z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+    z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+    return z ^ (z >> 31);
+}
+
+
+Sampler::Sampler () {
+
+    type = SAMPLER_RANDOM;
+    numDimensions = 1;
+
+    setSeed (SAMPLER_DEFAULT_SEED, 0);
+}
+
+
+Sampler::~Sampler () {
+
+}
+
+
+uint64_t Sampler::next () {
+
+    // xoshiro256** by D. Blackman and S. Vigna
+    uint64_t result = rotl (s[1] * 5, 7) * 9;
+    uint64_t t = s[1] << 17;
+
+    s[2] ^= s[0];
+    s[3] ^= s[1];
+    s[1] ^= s[2];
+    s[0] ^= s[3];
+    s[2] ^= t;
+    s[3] = rotl (s[3], 45);
+
+    return result;
+}
+
+
+int Sampler::jump () {
+
+    // Equivalent to 2^128 calls to next
+    static const uint64_t jumpPolynomial[4] = {
+        0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL, 0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL
+    };
+
+    uint64_t t[4] = {0, 0, 0, 0};
+    for (int i = 0; i < 4; i++) {
+        for (int b = 0; b < 64; b++) {
+            if (jumpPolynomial[i] & (1ULL << b)) {
+                for (int j = 0; j < 4; j++)
+                    t[j] ^= s[j];
+            }
+            next ();
+        }
+    }
+
+    for (int j = 0; j < 4; j++)
+        s[j] = t[j];
+
+    return 1;
+}
+
+
+int Sampler::reset () {
+
+    uint64_t x = scrambleSeed;
+
+    if (type == SAMPLER_HALTON) {
+
+        // Start at a random index, leaving out the first point at the origin
+        index = 1 + (splitmix64 (x) >> 44);
+    }
+    else if (type == SAMPLER_SOBOL) {
+
+        // Direction numbers, SOBOL_BITS per dimension
+        sobolDirections.resize (numDimensions*SOBOL_BITS);
+        for (int k = 0; k < SOBOL_BITS; k++)
+            sobolDirections[k] = 1U << (SOBOL_BITS - 1 - k);
+
+        for (int i = 1; i < numDimensions; i++) {
+
+            uint32_t *v = &(sobolDirections[i*SOBOL_BITS]);
+            int degree = sobolDegrees[i-1];
+            int coefficients = sobolCoefficients[i-1];
+
+            for (int k = 0; k < degree; k++)
+                v[k] = sobolInitial[i-1][k] << (SOBOL_BITS - 1 - k);
+
+            for (int k = degree; k < SOBOL_BITS; k++) {
+                v[k] = v[k-degree] ^ (v[k-degree] >> degree);
+                for (int j = 1; j < degree; j++)
+                    if ((coefficients >> (degree - 1 - j)) & 1)
+                        v[k] ^= v[k-j];
+            }
+        }
+
+        // Random digital shift
+        sobolPoint.resize (numDimensions);
+        for (int i = 0; i < numDimensions; i++)
+            sobolPoint[i] = (uint32_t)(splitmix64 (x) >> 32);
+
+        index = 0;
+    }
+
+    return 1;
+}
+
+
+int Sampler::setType (int typeIn) {
+
+    if ( (typeIn == SAMPLER_HALTON) && (numDimensions > HALTON_MAX_DIMENSIONS) )
+        return 0;
+    if ( (typeIn == SAMPLER_SOBOL) && (numDimensions > SOBOL_MAX_DIMENSIONS) )
+        return 0;
+    if ( (typeIn != SAMPLER_RANDOM) && (typeIn != SAMPLER_HALTON) && (typeIn != SAMPLER_SOBOL) )
+        return 0;
+
+    type = typeIn;
+
+    return reset ();
+}
+
+
+int Sampler::setNumDimensions (int numDimensionsIn) {
+
+    if (numDimensionsIn <= 0)
+        return 0;
+    if ( (type == SAMPLER_HALTON) && (numDimensionsIn > HALTON_MAX_DIMENSIONS) )
+        return 0;
+    if ( (type == SAMPLER_SOBOL) && (numDimensionsIn > SOBOL_MAX_DIMENSIONS) )
+        return 0;
+
+    numDimensions = numDimensionsIn;
+
+    return reset ();
+}
+
+
+int Sampler::setSeed (uint64_t seedIn, int streamIn) {
+
+    if (streamIn < 0)
+        return 0;
+
+    // Expand the seed into the generator state, which must not be all zero
+    uint64_t x = seedIn;
+    for (int j = 0; j < 4; j++)
+        s[j] = splitmix64 (x);
+
+    scrambleSeed = splitmix64 (x);
+
+    for (int i = 0; i < streamIn; i++)
+        jump ();
+
+    return reset ();
+}
+
+
+double Sampler::sampleUniform () {
+
+    // The upper 53 bits give all the doubles of the form k*2^-53
+    return (next () >> 11) * (1.0/9007199254740992.0);
+}
+
+
+double Sampler::sampleNormal () {
+
+    // Box-Muller transform, the first number is in (0,1] so that its logarithm is finite
+    double u1 = 1.0 - sampleUniform ();
+    double u2 = sampleUniform ();
+
+    return sqrt (-2.0*log (u1)) * cos (2.0*M_PI*u2);
+}
+
+
+int Sampler::samplePoint (double *pointOut) {
+
+    if (type == SAMPLER_RANDOM) {
+
+        for (int i = 0; i < numDimensions; i++)
+            pointOut[i] = sampleUniform ();
+    }
+    else if (type == SAMPLER_HALTON) {
+
+        for (int i = 0; i < numDimensions; i++) {
+
+            // Radical inverse of the index in base haltonBases[i]
+            double base = haltonBases[i];
+            double fraction = 1.0;
+            double result = 0.0;
+            for (uint64_t n = index; n > 0; n /= haltonBases[i]) {
+                fraction /= base;
+                result += fraction * (double)(n % haltonBases[i]);
+            }
+            pointOut[i] = result;
+        }
+        index++;
+    }
+    else {
+
+        for (int i = 0; i < numDimensions; i++)
+            pointOut[i] = sobolPoint[i] * (1.0/4294967296.0);
+
+        // Gray code order: flip the direction number of the lowest zero bit of the index
+        int c = 0;
+        while ((index >> c) & 1)
+            c++;
+        if (c >= SOBOL_BITS) {
+            reset ();
+            return 1;
+        }
+        for (int i = 0; i < numDimensions; i++)
+            sobolPoint[i] ^= sobolDirections[i*SOBOL_BITS + c];
+        index++;
+    }
+
+    return 1;
+}
@@ -0,0 +1,140 @@
+/*!
+ * \file sampler.h
+ */
+
+#ifndef __RRTS_SAMPLER_H_
+#define __RRTS_SAMPLER_H_
+
+#include <vector>
+
+#include <stdint.h>
+
+
+#define SAMPLER_RANDOM 0
+#define SAMPLER_HALTON 1
+#define SAMPLER_SOBOL 2
+
+#define SAMPLER_DEFAULT_SEED 0x5eed
+
+
+
+namespace RRTstar {
+
+
+    /*!
+     * \brief Source of the samples of a system
+     *
+     * Each system owns a sampler, so a planner can be seeded for reproducible
+     * runs. Every sampler starts with SAMPLER_DEFAULT_SEED on stream 0, so two
+     * samplers produce the same sequence until setSeed gives them different
+     * seeds or streams; planners running in different threads should call
+     * setSeed with the same seed and one stream each. Pseudo-random numbers
+     * come from a xoshiro256** generator. The points of the unit cube come
+     * either from the same generator (SAMPLER_RANDOM), from a Halton sequence
+     * started at an index chosen by the seed (SAMPLER_HALTON), or from a
+     * Sobol sequence scrambled with a random digital shift chosen by the seed
+     * (SAMPLER_SOBOL).
+     */
+    class Sampler {
+
+        int type;
+        int numDimensions;
+
+        uint64_t s[4];
+
+        // Chooses the start of the Halton sequence and the shift of the Sobol sequence
+        uint64_t scrambleSeed;
+
+        uint64_t index;
+        std::vector<uint32_t> sobolDirections;
+        std::vector<uint32_t> sobolPoint;
+
+        uint64_t next ();
+        int jump ();
+        int reset ();
+
+    public:
+
+        /*!
+         * \brief Sampler constructor
+         *
+         * Creates a SAMPLER_RANDOM sampler seeded with SAMPLER_DEFAULT_SEED.
+         */
+        Sampler ();
+
+        /*!
+         * \brief Sampler destructor
+         *
+         * More elaborate description
+         */
+        ~Sampler ();
+
+        /*!
+         * \brief Sets the sequence that samplePoint draws from
+         *
+         * Restarts the sequence.
+         *
+         * \param typeIn SAMPLER_RANDOM, SAMPLER_HALTON or SAMPLER_SOBOL
+         *
+         */
+        int setType (int typeIn);
+
+        /*!
+         * \brief Returns the sequence that samplePoint draws from
+         *
+         * More elaborate description
+         */
+        int getType () {return type;}
+
+        /*!
+         * \brief Sets the dimensionality of the points returned by samplePoint
+         *
+         * Restarts the sequence. The Halton sequence supports up to 16 and
+         * the Sobol sequence up to 10 dimensions.
+         *
+         * \param numDimensionsIn The new dimensionality
+         *
+         */
+        int setNumDimensions (int numDimensionsIn);
+
+        /*!
+         * \brief Seeds the generator and restarts the sequence
+         *
+         * Samplers with the same seed and different streams produce
+         * non-overlapping subsequences of length 2^128 of the same generator,
+         * which suits one sampler per thread.
+         *
+         * \param seedIn The seed
+         * \param streamIn Index of the stream, zero or larger
+         *
+         */
+        int setSeed (uint64_t seedIn, int streamIn);
+
+        /*!
+         * \brief Returns a pseudo-random number uniformly distributed in [0,1)
+         *
+         * More elaborate description
+         */
+        double sampleUniform ();
+
+        /*!
+         * \brief Returns a pseudo-random number with the standard normal distribution
+         *
+         * More elaborate description
+         */
+        double sampleNormal ();
+
+        /*!
+         * \brief Returns the next point of the sequence in the unit cube [0,1)^numDimensions
+         *
+         * More elaborate description
+         *
+         * \param pointOut The point, an array of dimension numDimensions
+         *
+         */
+        int samplePoint (double *pointOut);
+    };
+}
+
+
+#endif
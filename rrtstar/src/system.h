@@ -102,6 +102,17 @@ public:
      */
     State & getRootState ();
     
+    /*!
+     * \brief Sets the root state.
+     *
+     * The planners pass the state of their root vertex when they are
+     * initialized and when the tree is rerooted.
+     *
+     * \param stateIn The state of the root
+     *
+     */
+    int setRootState (State& stateIn);
+    
     /*!
      * \brief Returns the statekey for the given state.
      *
@@ -130,6 +141,48 @@ public:
      */
     int sampleState (State& randomStateOut);
     
+    /*!
+     * \brief Returns a sample state from the goal region.
+     *
+     * A more elaborate description.
+     *
+     * \param randomStateOut
+     *
+     */
+    int sampleGoalState (State& randomStateOut);
+    
+    /*!
+     * \brief Returns a sample state from the goal region, drawn with the given sampler.
+     *
+     * The planners draw their goal states through this method with their own
+     * sampler, so it must not touch the sampler that sampleState uses.
+     *
+     * \param randomStateOut
+     * \param samplerIn The sampler that draws the state
+     *
+     */
+    int sampleGoalState (State& randomStateOut, RRTstar::Sampler& samplerIn);
+    
+    /*!
+     * \brief Returns the maximum length of an extension, HUGE_VAL if unlimited.
+     *
+     * The planners steer new samples to within this cost of the nearest
+     * vertex and only consider near vertices within this cost.
+     */
+    double getMaxExtensionLength ();
+    
+    /*!
+     * \brief Moves stateTowardsInOut towards stateFromIn until it is within the
+     *        maximum extension length of stateFromIn.
+     *
+     * A more elaborate description.
+     *
+     * \param stateFromIn The state to steer from
+     * \param stateTowardsInOut The state to be truncated
+     *
+     */
+    int steerState (State& stateFromIn, State& stateTowardsInOut);
+    
     
     /*!
      * \brief Returns a the cost of the trajectory that connects stateFromIn and
@@ -182,6 +235,88 @@ public:
      *
      */
     int getTrajectory (State& stateFromIn, State& stateToIn, std::list< double* > & trajectoryOut);
+    
+    // Systems whose trajectories are determined by their end states may also
+    // specialize RRTstar::SystemTraits (system_traits.h) so that the planners
+    // do not store a Trajectory per vertex.
+
+    // The two methods below are optional. A system that provides
+    // evaluateExtensionCosts specializes RRTstar::SystemTraits<System>::
+    // batchCostQueries to true, and one that provides extendToStates
+    // specializes batchCollisionQueries to true. The planners then query all
+    // the near vertices of a state in one call instead of one
+    // evaluateExtensionCost or extendTo per vertex.
+
+    /*!
+     * \brief Returns the costs of the trajectories between stateIn and each of the states
+     *
+     * A more elaborate description.
+     *
+     * \param stateIn The common end state
+     * \param statesIn The other end states, an array of numStatesIn pointers
+     * \param numStatesIn Number of the other end states
+     * \param fromStateIn Set to true if the trajectories start at stateIn,
+     *                    false if they reach stateIn
+     * \param costsOut The costs, an array of dimension numStatesIn
+     * \param exactConnectionsOut Set to true where the states can be connected exactly
+     *
+     */
+    int evaluateExtensionCosts (State& stateIn, State** statesIn, int numStatesIn, bool fromStateIn,
+                                double* costsOut, bool* exactConnectionsOut);
+
+    /*!
+     * \brief Computes the trajectories between stateIn and each of the states, checking for collision
+     *
+     * A more elaborate description.
+     *
+     * \param stateIn The common end state
+     * \param statesIn The other end states, an array of numStatesIn pointers
+     * \param numStatesIn Number of the other end states
+     * \param fromStateIn Set to true if the trajectories start at stateIn,
+     *                    false if they reach stateIn
+     * \param trajectoriesOut The trajectories, an array of dimension numStatesIn
+     * \param exactConnectionsOut Set to true where the states can be connected exactly
+     * \param validOut Set to true where the trajectory is collision free
+     *
+     */
+    int extendToStates (State& stateIn, State** statesIn, int numStatesIn, bool fromStateIn,
+                        Trajectory* trajectoriesOut, bool* exactConnectionsOut, bool* validOut);
+
+    /*!
+     * \brief Returns true if the trajectory between the two states crosses a region
+     *        that became blocked since the last clearObstacleUpdates.
+     *
+     * A more elaborate description.
+     *
+     * \param stateFromIn Initial state
+     * \param stateToIn Final state
+     *
+     */
+    bool isBlockedByObstacleUpdate (State& stateFromIn, State& stateToIn);
+    
+    /*!
+     * \brief Returns true if the state is within the given radius, measured in the
+     *        units of the state key, of a region that was freed since the last
+     *        clearObstacleUpdates.
+     *
+     * A more elaborate description.
+     *
+     */
+    bool isNearFreedRegion (State& stateIn, double keyRadiusIn);
+    
+    /*!
+     * \brief Returns true if obstacles changed since the last clearObstacleUpdates.
+     *
+     * A more elaborate description.
+     */
+    bool hasObstacleUpdates ();
+    
+    /*!
+     * \brief Forgets the recorded obstacle changes.
+     *
+     * A more elaborate description.
+     */
+    int clearObstacleUpdates ();
 };
 
 #endif
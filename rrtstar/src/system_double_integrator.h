@@ -0,0 +1,439 @@
+/*!
+ * \file system_double_integrator.h
+ */
+
+#ifndef __RRTS_SYSTEM_DOUBLE_INTEGRATOR_H_
+#define __RRTS_SYSTEM_DOUBLE_INTEGRATOR_H_
+
+#include <array>
+#include <list>
+#include <vector>
+
+#include "system_single_integrator.h"
+
+
+
+namespace DoubleIntegrator {
+
+
+    template<int N> class Trajectory;
+    template<int N> class System;
+
+
+    /*!
+     * \brief State Class of a double integrator in N dimensions.
+     *
+     * The first N coordinates are the position and the last N the velocity.
+     * The coordinates are stored in the object, so copying and assigning a
+     * state does not allocate memory.
+     */
+    template<int N>
+    class State {
+
+        std::array<double,2*N> x;
+
+    public:
+
+        /*!
+         * \brief State constructor
+         *
+         * More elaborate description
+         */
+        State () {x.fill (0.0);}
+
+        /*!
+         * \brief State bracket operator
+         *
+         * More elaborate description
+         */
+        double& operator[] (const int i) {return x[i];}
+
+        friend class System<N>;
+        friend class Trajectory<N>;
+    };
+
+
+
+    /*!
+     * \brief Trajectory Class of a double integrator in N dimensions.
+     *
+     * Keeps the end state, the duration and the cost of the trajectory.
+     * The trajectory itself is determined by its two end states.
+     */
+    template<int N>
+    class Trajectory {
+
+        State<N> endState;
+        double duration;
+        double cost;
+
+    public:
+
+        /*!
+         * \brief Trajectory constructor
+         *
+         * More elaborate description
+         */
+        Trajectory () : duration (0.0), cost (0.0) {}
+
+        /*!
+         * \brief Returns a reference to the end state of this trajectory.
+         *
+         * More elaborate description
+         */
+        State<N>& getEndState () {return endState;}
+
+        /*!
+         * \brief Returns the duration of this trajectory.
+         *
+         * More elaborate description
+         */
+        double getDuration () {return duration;}
+
+        /*!
+         * \brief Returns the cost of this trajectory.
+         *
+         * More elaborate description
+         */
+        double evaluateCost () {return cost;}
+
+        friend class System<N>;
+    };
+
+
+
+    /*!
+     * \brief System Class of a double integrator in N dimensions.
+     *
+     * The acceleration is the control input. The cost of a trajectory of
+     * duration T is T plus the energy weight times the integral of the
+     * squared acceleration. Between two states the optimal trajectory is a
+     * cubic polynomial in each dimension, and its duration is the positive
+     * root of a quartic polynomial of lowest cost, which is found in closed
+     * form. The cost-to-go is the cost of reaching the distance to the goal
+     * region along the direction to it with a free final velocity, which is
+     * a lower bound on the cost of any trajectory that reaches the goal.
+     *
+     * The system uses the environment, the collision checking modes and the
+     * obstacle updates of SingleIntegrator::System on the positions. A
+     * trajectory is checked for collision at sample times computed in one
+     * pass per dimension, along the chords between consecutive samples. The
+     * samples are dense enough that the trajectory deviates from the chords
+     * by at most the collision tolerance, and a trajectory that would need
+     * more than DOUBLE_INTEGRATOR_MAX_SAMPLES samples is treated as in
+     * collision. The obstacles are not inflated, so a trajectory may cut up
+     * to the collision tolerance into an obstacle; inflate the obstacles by
+     * the tolerance for a strict guarantee. The goal region only constrains
+     * the position, and the maximum extension length bounds the cost of an
+     * extension. The potential field, the narrow passage sampling, the
+     * navigation field, the corridor sampling and the additional goal
+     * regions of SingleIntegrator::System are not supported, and their
+     * setters return 0.
+     */
+    template<int N>
+    class System : public SingleIntegrator::System {
+
+        State<N> rootState;
+
+        double energyWeight;
+        double velocityRange;
+        double collisionTolerance;
+
+        // Sample times and positions of the last sampled trajectory, one dimension after the other
+        int numTrajectorySamples;
+        std::vector<double> trajectoryTimes;
+        std::vector<double> trajectoryPositions;
+
+        int SolveDepressedQuartic (double p, double q, double r, double *rootsOut);
+
+        double EvaluateDuration (State<N> &stateFromIn, State<N> &stateToIn, double& costOut);
+        int EvaluateCoefficients (State<N> &stateFromIn, State<N> &stateToIn, double durationIn,
+                                  double *c2Out, double *c3Out);
+        int SampleTrajectory (State<N> &stateFromIn, State<N> &stateToIn, double durationIn);
+        bool IsTrajectoryInCollision (State<N> &stateFromIn, State<N> &stateToIn, double durationIn);
+
+    public:
+
+        /*!
+         * \brief System constructor
+         *
+         * More elaborate description
+         */
+        System ();
+
+        /*!
+         * \brief Sets the number of positions, only N is supported
+         *
+         * Keeps the sampler at 2*N dimensions, for the positions and the
+         * velocities.
+         *
+         * \param numDimensionsIn N
+         *
+         */
+        int setNumDimensions (int numDimensionsIn);
+
+        /*!
+         * \brief Sets the lower bound on the cost to go, only COST_TO_GO_EUCLIDEAN is supported
+         *
+         * The cost to go is computed from the positions and the velocities,
+         * and does not use the navigation field, so the setter returns 0 for
+         * COST_TO_GO_NAVIGATION_FIELD.
+         *
+         * \param costToGoModeIn COST_TO_GO_EUCLIDEAN
+         *
+         */
+        int setCostToGoMode (int costToGoModeIn);
+
+        /*!
+         * \brief Sets the gradient descent of the samples, only RGD_AXIS_STEPS is supported
+         *
+         * The samples are not descended in either mode, so the setter returns 0
+         * for RGD_POTENTIAL_FIELD, and the potential field is not built.
+         *
+         * \param rgdModeIn RGD_AXIS_STEPS
+         *
+         */
+        int setRGDMode (int rgdModeIn);
+
+        /*!
+         * \brief Sets the corridor sampling, only a zero ratio is supported
+         *
+         * The samples are not drawn in the corridor, so the setter returns 0
+         * for a positive ratio.
+         *
+         * \param ratioIn The fraction of the samples, zero
+         * \param slackIn The slack of the corridor
+         *
+         */
+        int setCorridorSampling (double ratioIn, double slackIn);
+
+        /*!
+         * \brief Sets the narrow passage sampling, only zero ratios are supported
+         *
+         * The samples are drawn uniformly, so the setter returns 0 for a
+         * positive Gaussian or bridge test ratio.
+         *
+         * \param gaussianRatioIn The fraction of the samples drawn with Gaussian sampling, zero
+         * \param bridgeRatioIn The fraction of the samples drawn with the bridge test, zero
+         * \param deviationIn The standard deviation of the pair offsets
+         *
+         */
+        int setNarrowPassageSampling (double gaussianRatioIn, double bridgeRatioIn, double deviationIn);
+
+        /*!
+         * \brief Returns 0, this system only reaches regionGoal
+         *
+         * A more elaborate description.
+         */
+        int addGoalRegion (SingleIntegrator::region *regionIn);
+
+        /*!
+         * \brief Sets the weight of the integral of the squared acceleration in the cost
+         *
+         * The default is 1.0. Larger weights give slower and smoother trajectories.
+         *
+         * \param energyWeightIn The new weight, larger than zero
+         *
+         */
+        int setEnergyWeight (double energyWeightIn);
+
+        /*!
+         * \brief Sets the range of the velocities of the sample states
+         *
+         * The velocities are sampled uniformly in [-velocityRangeIn, velocityRangeIn]
+         * along each dimension. The default is 1.0.
+         *
+         * \param velocityRangeIn The new range, larger than zero
+         *
+         */
+        int setVelocityRange (double velocityRangeIn);
+
+        /*!
+         * \brief Sets the largest distance between a trajectory and the chords that are checked for collision
+         *
+         * The default is 0.1.
+         *
+         * \param collisionToleranceIn The new tolerance, larger than zero
+         *
+         */
+        int setCollisionTolerance (double collisionToleranceIn);
+
+        /*!
+         * \brief Returns the dimensionality of the state space, twice the number of positions.
+         *
+         * A more elaborate description.
+         */
+        int getNumDimensions () {return 2*N;}
+
+        /*!
+         * \brief Returns a reference to the root state.
+         *
+         * A more elaborate description.
+         */
+        State<N>& getRootState () {return rootState;}
+
+        /*!
+         * \brief Sets the root state.
+         *
+         * A more elaborate description.
+         */
+        int setRootState (State<N>& stateIn) {rootState = stateIn; return 1;}
+
+        /*!
+         * \brief Returns the statekey for the given state.
+         *
+         * The positions are scaled by the size of the operating region and
+         * the velocities by the width of the velocity range.
+         *
+         * \param stateIn the given state
+         * \param stateKey the key to the state. An array of dimension 2*N
+         *
+         */
+        int getStateKey (State<N> &stateIn, double *stateKey);
+
+        /*!
+         * \brief Returns true if the position of the given state is in the goal region.
+         *
+         * A more elaborate description.
+         */
+        bool isReachingTarget (State<N> &stateIn);
+
+        /*!
+         * \brief Returns a sample state with a collision free position.
+         *
+         * A more elaborate description.
+         *
+         * \param randomStateOut
+         *
+         */
+        int sampleState (State<N> &randomStateOut);
+
+        /*!
+         * \brief Returns a sample state with a position from the goal region.
+         *
+         * A more elaborate description.
+         *
+         * \param randomStateOut
+         *
+         */
+        int sampleGoalState (State<N> &randomStateOut);
+
+        /*!
+         * \brief Returns a sample state from the goal region, drawn with the given sampler.
+         *
+         * Does not touch the sampler of the system.
+         *
+         * \param randomStateOut
+         * \param samplerIn The sampler that draws the state
+         *
+         */
+        int sampleGoalState (State<N> &randomStateOut, RRTstar::Sampler &samplerIn);
+
+        /*!
+         * \brief Moves stateTowardsInOut along the optimal trajectory from stateFromIn until
+         *        the cost from stateFromIn is within the maximum extension length.
+         *
+         * A more elaborate description.
+         *
+         * \param stateFromIn The state to steer from
+         * \param stateTowardsInOut The state to be truncated
+         *
+         */
+        int steerState (State<N> &stateFromIn, State<N> &stateTowardsInOut);
+
+        /*!
+         * \brief Returns a the cost of the trajectory that connects stateFromIn and
+         *        stateTowardsIn. The trajectory is also returned in trajectoryOut.
+         *
+         * A more elaborate description.
+         *
+         * \param stateFromIn Initial state
+         * \param stateTowardsIn Final state
+         * \param trajectoryOut Trajectory that starts the from the initial state and
+         *                      reaches near the final state.
+         * \param exactConnectionOut Set to true if the initial and the final states
+         *                           can be connected exactly.
+         *
+         */
+        int extendTo (State<N> &stateFromIn, State<N> &stateTowardsIn,
+                      Trajectory<N> &trajectoryOut, bool &exactConnectionOut);
+
+        /*!
+         * \brief Returns the cost of the trajectory that connects stateFromIn and StateTowardsIn.
+         *
+         * A more elaborate description.
+         *
+         * \param stateFromIn Initial state
+         * \param stateTowardsIn Final state
+         * \param exactConnectionOut Set to true if the initial and the final states
+         *                           can be connected exactly.
+         *
+         */
+        double evaluateExtensionCost (State<N> &stateFromIn, State<N> &stateTowardsIn, bool &exactConnectionOut);
+
+        /*!
+         * \brief Returns a lower bound on the cost to go starting from stateIn
+         *
+         * A more elaborate description.
+         *
+         * \param stateIn Starting state
+         *
+         */
+        double evaluateCostToGo (State<N>& stateIn);
+
+        /*!
+         * \brief Returns the trajectory as a list of double arrays, each with dimension 2*N.
+         *
+         * The states are sampled as in the collision check, leaving out the
+         * initial state.
+         *
+         * \param stateFromIn Initial state
+         * \param stateToIn Final state
+         * \param trajectoryOut The list of double arrays that represent the trajectory
+         *
+         */
+        int getTrajectory (State<N>& stateFromIn, State<N>& stateToIn, std::list<double*>& trajectoryOut);
+
+        /*!
+         * \brief Returns true if the trajectory between the two states crosses a
+         *        region that became blocked since the last clearObstacleUpdates.
+         *
+         * A more elaborate description.
+         *
+         * \param stateFromIn Initial state
+         * \param stateToIn Final state
+         *
+         */
+        bool isBlockedByObstacleUpdate (State<N>& stateFromIn, State<N>& stateToIn);
+
+        /*!
+         * \brief Returns true if the position of the state is within the given radius
+         *        of a region that was freed since the last clearObstacleUpdates.
+         *
+         * A more elaborate description.
+         *
+         * \param stateIn The state
+         * \param keyRadiusIn The radius, measured in the units of the state key
+         *
+         */
+        bool isNearFreedRegion (State<N>& stateIn, double keyRadiusIn);
+    };
+}
+
+
+
+
+namespace RRTstar {
+
+
+    // The trajectories are determined by their end states
+    template<int N>
+    struct SystemTraits< DoubleIntegrator::System<N> > {
+        static const bool storeTrajectories = false;
+        static const bool batchCostQueries = false;
+        static const bool batchCollisionQueries = false;
+    };
+}
+
+
+#endif
@@ -0,0 +1,685 @@
+/*!
+ * \file system_double_integrator.hpp
+ */
+
+#ifndef __RRTS_SYSTEM_DOUBLE_INTEGRATOR_HPP_
+#define __RRTS_SYSTEM_DOUBLE_INTEGRATOR_HPP_
+
+#include <cmath>
+#include <cstdlib>
+
+
+#include "system_double_integrator.h"
+
+
+#define DOUBLE_INTEGRATOR_MAX_SAMPLES 1000
+
+
+
+template<int N>
+DoubleIntegrator::System<N>
+::System () {
+
+    setNumDimensions (N);
+
+    regionOperating.setNumDimensions (N);
+    regionGoal.setNumDimensions (N);
+    for (int i = 0; i < N; i++) {
+        regionOperating.center[i] = 0.0;
+        regionOperating.size[i] = 0.0;
+        regionGoal.center[i] = 0.0;
+        regionGoal.size[i] = 0.0;
+    }
+
+    energyWeight = 1.0;
+    velocityRange = 1.0;
+    collisionTolerance = 0.1;
+
+    numTrajectorySamples = 0;
+}
+
+
+template<int N>
+int
+DoubleIntegrator::System<N>
+::setNumDimensions (int numDimensionsIn) {
+
+    if (numDimensionsIn != N)
+        return 0;
+
+    SingleIntegrator::System::setNumDimensions (N);
+
+    // The samples have a position and a velocity
+    getSampler().setNumDimensions (2*N);
+
+    return 1;
+}
+
+
+template<int N>
+int
+DoubleIntegrator::System<N>
+::setCostToGoMode (int costToGoModeIn) {
+
+    if (costToGoModeIn != SingleIntegrator::COST_TO_GO_EUCLIDEAN)
+        return 0;
+
+    return SingleIntegrator::System::setCostToGoMode (costToGoModeIn);
+}
+
+
+template<int N>
+int
+DoubleIntegrator::System<N>
+::setRGDMode (int rgdModeIn) {
+
+    if (rgdModeIn != SingleIntegrator::RGD_AXIS_STEPS)
+        return 0;
+
+    return SingleIntegrator::System::setRGDMode (rgdModeIn);
+}
+
+
+template<int N>
+int
+DoubleIntegrator::System<N>
+::setCorridorSampling (double ratioIn, double slackIn) {
+
+    if (ratioIn > 0.0)
+        return 0;
+
+    return SingleIntegrator::System::setCorridorSampling (ratioIn, slackIn);
+}
+
+
+template<int N>
+int
+DoubleIntegrator::System<N>
+::setNarrowPassageSampling (double gaussianRatioIn, double bridgeRatioIn, double deviationIn) {
+
+    if ( (gaussianRatioIn > 0.0) || (bridgeRatioIn > 0.0) )
+        return 0;
+
+    return SingleIntegrator::System::setNarrowPassageSampling (gaussianRatioIn, bridgeRatioIn, deviationIn);
+}
+
+
+template<int N>
+int
+DoubleIntegrator::System<N>
+::addGoalRegion (SingleIntegrator::region *) {
+
+    return 0;
+}
+
+
+template<int N>
+int
+DoubleIntegrator::System<N>
+::setEnergyWeight (double energyWeightIn) {
+
+    if (energyWeightIn <= 0.0)
+        return 0;
+
+    energyWeight = energyWeightIn;
+
+    return 1;
+}
+
+
+template<int N>
+int
+DoubleIntegrator::System<N>
+::setVelocityRange (double velocityRangeIn) {
+
+    if (velocityRangeIn <= 0.0)
+        return 0;
+
+    velocityRange = velocityRangeIn;
+
+    return 1;
+}
+
+
+template<int N>
+int
+DoubleIntegrator::System<N>
+::setCollisionTolerance (double collisionToleranceIn) {
+
+    if (collisionToleranceIn <= 0.0)
+        return 0;
+
+    collisionTolerance = collisionToleranceIn;
+
+    return 1;
+}
+
+
+template<int N>
+int
+DoubleIntegrator::System<N>
+::SolveDepressedQuartic (double p, double q, double r, double *rootsOut) {
+
+    // Real roots of y^4 + p y^2 + q y + r, at most four
+    int numRoots = 0;
+
+    if (fabs (q) < 1e-12) {
+
+        // Biquadratic, a quadratic in y^2
+        double disc = p*p - 4.0*r;
+        if (disc < 0.0)
+            return 0;
+        double z[2] = {(-p + sqrt (disc))/2.0, (-p - sqrt (disc))/2.0};
+        for (int j = 0; j < 2; j++) {
+            if (z[j] >= 0.0) {
+                rootsOut[numRoots++] = sqrt (z[j]);
+                rootsOut[numRoots++] = -sqrt (z[j]);
+            }
+        }
+    }
+    else {
+
+        // Ferrari: the largest root m of the resolvent cubic
+        //   m^3 + p m^2 + (p^2/4 - r) m - q^2/8 is positive, by Cardano
+        double a2 = p;
+        double a1 = p*p/4.0 - r;
+        double a0 = -q*q/8.0;
+        double P = a1 - a2*a2/3.0;
+        double Q = 2.0*a2*a2*a2/27.0 - a2*a1/3.0 + a0;
+        double disc = Q*Q/4.0 + P*P*P/27.0;
+
+        double t;
+        if (disc >= 0.0)
+            t = cbrt (-Q/2.0 + sqrt (disc)) + cbrt (-Q/2.0 - sqrt (disc));
+        else {
+            double c = 3.0*Q/(2.0*P)*sqrt (-3.0/P);
+            if (c > 1.0)
+                c = 1.0;
+            if (c < -1.0)
+                c = -1.0;
+            t = 2.0*sqrt (-P/3.0)*cos (acos (c)/3.0);
+        }
+
+        double m = t - a2/3.0;
+        for (int k = 0; k < 2; k++) {
+            double f = ((m + a2)*m + a1)*m + a0;
+            double df = (3.0*m + 2.0*a2)*m + a1;
+            if (df != 0.0)
+                m -= f/df;
+        }
+        if (!(m > 0.0))
+            return 0;
+
+        // The quartic splits into y^2 -+ s y + m + p/2 +- q/(2s), with s = sqrt(2m)
+        double s = sqrt (2.0*m);
+        for (int sign = -1; sign <= 1; sign += 2) {
+            double b = sign*s;
+            double c = m + p/2.0 - sign*q/(2.0*s);
+            double discCurr = b*b - 4.0*c;
+            if (discCurr < 0.0)
+                continue;
+            rootsOut[numRoots++] = (-b + sqrt (discCurr))/2.0;
+            rootsOut[numRoots++] = (-b - sqrt (discCurr))/2.0;
+        }
+    }
+
+    // Polish the roots with Newton steps on the quartic
+    for (int j = 0; j < numRoots; j++) {
+        for (int k = 0; k < 2; k++) {
+            double y = rootsOut[j];
+            double f = ((y*y + p)*y + q)*y + r;
+            double df = (4.0*y*y + 2.0*p)*y + q;
+            if (df != 0.0)
+                rootsOut[j] = y - f/df;
+        }
+    }
+
+    return numRoots;
+}
+
+
+template<int N>
+double
+DoubleIntegrator::System<N>
+::EvaluateDuration (State<N> &stateFromIn, State<N> &stateToIn, double& costOut) {
+
+    // The minimum energy for a duration T is 12c/T^3 - 12b/T^2 + 4a/T
+    double a = 0.0;
+    double b = 0.0;
+    double c = 0.0;
+    for (int i = 0; i < N; i++) {
+        double d = stateToIn.x[i] - stateFromIn.x[i];
+        double v0 = stateFromIn.x[N+i];
+        double v1 = stateToIn.x[N+i];
+        a += v0*v0 + v0*v1 + v1*v1;
+        b += d*(v0 + v1);
+        c += d*d;
+    }
+
+    costOut = 0.0;
+    if ( (a == 0.0) && (c == 0.0) )
+        return 0.0;
+
+    // The derivative of the cost vanishes at the roots of T^4 - 4wa T^2 + 24wb T - 36wc
+    double w = energyWeight;
+    double roots[4];
+    int numRoots = SolveDepressedQuartic (-4.0*w*a, 24.0*w*b, -36.0*w*c, roots);
+
+    double durationOut = 0.0;
+    costOut = HUGE_VAL;
+    for (int j = 0; j < numRoots; j++) {
+        double T = roots[j];
+        if (!(T > 0.0))
+            continue;
+        double costCurr = T + w*(((12.0*c/T - 12.0*b)/T + 4.0*a)/T);
+        if (costCurr < costOut) {
+            costOut = costCurr;
+            durationOut = T;
+        }
+    }
+
+    return durationOut;
+}
+
+
+template<int N>
+int
+DoubleIntegrator::System<N>
+::EvaluateCoefficients (State<N> &stateFromIn, State<N> &stateToIn, double durationIn,
+                        double *c2Out, double *c3Out) {
+
+    // p(t) = p0 + v0 t + c2 t^2 + c3 t^3 meets the final position and velocity at t = T
+    for (int i = 0; i < N; i++) {
+
+        if (durationIn <= 0.0) {
+            c2Out[i] = 0.0;
+            c3Out[i] = 0.0;
+            continue;
+        }
+
+        double T = durationIn;
+        double dp = stateToIn.x[i] - stateFromIn.x[i] - stateFromIn.x[N+i]*T;
+        double dv = stateToIn.x[N+i] - stateFromIn.x[N+i];
+        c2Out[i] = (3.0*dp - T*dv)/(T*T);
+        c3Out[i] = (T*dv - 2.0*dp)/(T*T*T);
+    }
+
+    return 1;
+}
+
+
+template<int N>
+int
+DoubleIntegrator::System<N>
+::SampleTrajectory (State<N> &stateFromIn, State<N> &stateToIn, double durationIn) {
+
+    double c2[N], c3[N];
+    EvaluateCoefficients (stateFromIn, stateToIn, durationIn, c2, c3);
+
+    // The acceleration is linear in time, so it is largest at one of the ends
+    double accelerationMax = 0.0;
+    for (int i = 0; i < N; i++) {
+        double accelerationCurr = fmax (fabs (2.0*c2[i]), fabs (2.0*c2[i] + 6.0*c3[i]*durationIn));
+        accelerationMax += accelerationCurr*accelerationCurr;
+    }
+    accelerationMax = sqrt (accelerationMax);
+
+    // A chord of duration dt deviates from the trajectory by at most accelerationMax dt^2/8
+    int numIntervals = 1;
+    bool withinTolerance = true;
+    if (accelerationMax > 0.0) {
+        double intervals = ceil (durationIn/sqrt (8.0*collisionTolerance/accelerationMax));
+        if (intervals > DOUBLE_INTEGRATOR_MAX_SAMPLES) {
+            intervals = DOUBLE_INTEGRATOR_MAX_SAMPLES;
+            withinTolerance = false;
+        }
+        if (intervals > 1.0)
+            numIntervals = (int)intervals;
+    }
+    numTrajectorySamples = numIntervals + 1;
+
+    trajectoryTimes.resize (numTrajectorySamples);
+    for (int k = 0; k < numTrajectorySamples; k++)
+        trajectoryTimes[k] = durationIn*k/numIntervals;
+
+    // Evaluate the polynomials at all the sample times, one dimension at a time
+    trajectoryPositions.resize (N*numTrajectorySamples);
+    const double *times = &(trajectoryTimes[0]);
+    for (int i = 0; i < N; i++) {
+
+        double p0 = stateFromIn.x[i];
+        double v0 = stateFromIn.x[N+i];
+        double c2Curr = c2[i];
+        double c3Curr = c3[i];
+        double *positions = &(trajectoryPositions[i*numTrajectorySamples]);
+        for (int k = 0; k < numTrajectorySamples; k++)
+            positions[k] = p0 + times[k]*(v0 + times[k]*(c2Curr + times[k]*c3Curr));
+        positions[numIntervals] = stateToIn.x[i];
+    }
+
+    // The chords are farther than the collision tolerance from the trajectory
+    if (!withinTolerance)
+        return 0;
+
+    return numTrajectorySamples;
+}
+
+
+template<int N>
+bool
+DoubleIntegrator::System<N>
+::IsTrajectoryInCollision (State<N> &stateFromIn, State<N> &stateToIn, double durationIn) {
+
+    // Trajectories that need more samples than DOUBLE_INTEGRATOR_MAX_SAMPLES are not checked
+    if (SampleTrajectory (stateFromIn, stateToIn, durationIn) <= 0)
+        return true;
+
+    // The trajectory may leave the operating region between the two states
+    for (int i = 0; i < N; i++) {
+
+        double *positions = &(trajectoryPositions[i*numTrajectorySamples]);
+        double positionMin = positions[0];
+        double positionMax = positions[0];
+        for (int k = 1; k < numTrajectorySamples; k++) {
+            positionMin = fmin (positionMin, positions[k]);
+            positionMax = fmax (positionMax, positions[k]);
+        }
+
+        if ( (positionMin < regionOperating.center[i] - regionOperating.size[i]/2.0)
+             || (positionMax > regionOperating.center[i] + regionOperating.size[i]/2.0) )
+            return true;
+    }
+
+    // Check the chords between consecutive samples
+    double stateFrom[N], stateTo[N];
+    for (int k = 0; k < numTrajectorySamples - 1; k++) {
+
+        for (int i = 0; i < N; i++) {
+            stateFrom[i] = trajectoryPositions[i*numTrajectorySamples + k];
+            stateTo[i] = trajectoryPositions[i*numTrajectorySamples + k + 1];
+        }
+
+        if (IsInCollision (stateFrom, stateTo))
+            return true;
+    }
+
+    return false;
+}
+
+
+template<int N>
+int
+DoubleIntegrator::System<N>
+::getStateKey (State<N>& stateIn, double* stateKey) {
+
+    for (int i = 0; i < N; i++) {
+        stateKey[i] = stateIn.x[i] / regionOperating.size[i];
+        stateKey[N+i] = stateIn.x[N+i] / (2.0*velocityRange);
+    }
+
+    return 1;
+}
+
+
+template<int N>
+bool
+DoubleIntegrator::System<N>
+::isReachingTarget (State<N> &stateIn) {
+
+    for (int i = 0; i < N; i++) {
+
+        if (fabs(stateIn.x[i] - regionGoal.center[i]) > regionGoal.size[i]/2.0 )
+            return false;
+    }
+
+    return true;
+}
+
+
+template<int N>
+int
+DoubleIntegrator::System<N>
+::sampleState (State<N> &randomStateOut) {
+
+    getSampler().samplePoint (randomStateOut.x.data());
+    for (int i = 0; i < N; i++) {
+
+        randomStateOut.x[i] = randomStateOut.x[i]*regionOperating.size[i]
+        - regionOperating.size[i]/2.0 + regionOperating.center[i];
+
+        randomStateOut.x[N+i] = (2.0*randomStateOut.x[N+i] - 1.0)*velocityRange;
+    }
+
+    if (IsInCollision (randomStateOut.x.data()))
+        return 0;
+
+    return 1;
+}
+
+
+template<int N>
+int
+DoubleIntegrator::System<N>
+::sampleGoalState (State<N> &randomStateOut) {
+
+    return sampleGoalState (randomStateOut, getSampler());
+}
+
+
+template<int N>
+int
+DoubleIntegrator::System<N>
+::sampleGoalState (State<N> &randomStateOut, RRTstar::Sampler &samplerIn) {
+
+    for (int i = 0; i < N; i++) {
+
+        randomStateOut.x[i] = samplerIn.sampleUniform ()*regionGoal.size[i]
+        - regionGoal.size[i]/2.0 + regionGoal.center[i];
+    }
+
+    for (int i = 0; i < N; i++)
+        randomStateOut.x[N+i] = (2.0*samplerIn.sampleUniform () - 1.0)*velocityRange;
+
+    if (IsInCollision (randomStateOut.x.data()))
+        return 0;
+
+    return 1;
+}
+
+
+template<int N>
+int
+DoubleIntegrator::System<N>
+::steerState (State<N> &stateFromIn, State<N> &stateTowardsInOut) {
+
+    double maxExtensionLength = getMaxExtensionLength ();
+
+    double cost;
+    double duration = EvaluateDuration (stateFromIn, stateTowardsInOut, cost);
+    if (cost <= maxExtensionLength)
+        return 1;
+
+    double c2[N], c3[N];
+    EvaluateCoefficients (stateFromIn, stateTowardsInOut, duration, c2, c3);
+
+    // The cost of the first part of the trajectory grows with its duration,
+    //   bisect for the duration that costs the maximum extension length
+    double timeLow = 0.0;
+    double timeHigh = duration;
+    for (int k = 0; k < 50; k++) {
+
+        double t = (timeLow + timeHigh)/2.0;
+        double energy = 0.0;
+        for (int i = 0; i < N; i++) {
+            double alpha = 2.0*c2[i];
+            double beta = 6.0*c3[i];
+            energy += ((beta*beta/3.0*t + alpha*beta)*t + alpha*alpha)*t;
+        }
+
+        if (t + energyWeight*energy <= maxExtensionLength)
+            timeLow = t;
+        else
+            timeHigh = t;
+    }
+
+    // Any trajectory to the state on the way costs at most as much as the way there
+    double t = timeLow;
+    for (int i = 0; i < N; i++) {
+        double p0 = stateFromIn.x[i];
+        double v0 = stateFromIn.x[N+i];
+        stateTowardsInOut.x[i] = p0 + t*(v0 + t*(c2[i] + t*c3[i]));
+        stateTowardsInOut.x[N+i] = v0 + t*(2.0*c2[i] + 3.0*c3[i]*t);
+    }
+
+    return 1;
+}
+
+
+template<int N>
+int
+DoubleIntegrator::System<N>
+::extendTo (State<N> &stateFromIn, State<N> &stateTowardsIn, Trajectory<N> &trajectoryOut, bool &exactConnectionOut) {
+
+    double cost;
+    double duration = EvaluateDuration (stateFromIn, stateTowardsIn, cost);
+
+    if (IsTrajectoryInCollision (stateFromIn, stateTowardsIn, duration))
+        return 0;
+
+    trajectoryOut.endState = stateTowardsIn;
+    trajectoryOut.duration = duration;
+    trajectoryOut.cost = cost;
+
+    exactConnectionOut = true;
+
+    return 1;
+}
+
+
+template<int N>
+double
+DoubleIntegrator::System<N>
+::evaluateExtensionCost (State<N>& stateFromIn, State<N>& stateTowardsIn, bool &exactConnectionOut) {
+
+    exactConnectionOut = true;
+
+    double cost;
+    EvaluateDuration (stateFromIn, stateTowardsIn, cost);
+
+    return cost;
+}
+
+
+template<int N>
+double
+DoubleIntegrator::System<N>
+::evaluateCostToGo (State<N>& stateIn) {
+
+    // Distance and direction to the nearest point of the goal region
+    double direction[N];
+    double dist = 0.0;
+    for (int i = 0; i < N; i++) {
+        double positionGoal = fmin (fmax (stateIn.x[i], regionGoal.center[i] - regionGoal.size[i]/2.0),
+                                    regionGoal.center[i] + regionGoal.size[i]/2.0);
+        direction[i] = positionGoal - stateIn.x[i];
+        dist += direction[i]*direction[i];
+    }
+    dist = sqrt (dist);
+    if (dist == 0.0)
+        return 0.0;
+
+    double speed = 0.0;
+    for (int i = 0; i < N; i++)
+        speed += stateIn.x[N+i]*direction[i]/dist;
+
+    // Every point of the goal region is at least dist away along the direction, and
+    //   covering dist in time T with a free final velocity takes at least
+    //   3 (dist - speed T)^2/T^3 of energy, whose sum with T is smallest at T = dist/speed
+    //   or at a root of T^4 - 3w speed^2 T^2 + 12w dist speed T - 9w dist^2
+    double w = energyWeight;
+    double roots[4];
+    int numRoots = SolveDepressedQuartic (-3.0*w*speed*speed, 12.0*w*dist*speed, -9.0*w*dist*dist, roots);
+
+    double costToGo = HUGE_VAL;
+    if (speed > 0.0)
+        costToGo = dist/speed;
+    for (int j = 0; j < numRoots; j++) {
+        double T = roots[j];
+        if (!(T > 0.0))
+            continue;
+        double distRemaining = fmax (dist - speed*T, 0.0);
+        double costCurr = T + 3.0*w*distRemaining*distRemaining/(T*T*T);
+        if (costCurr < costToGo)
+            costToGo = costCurr;
+    }
+
+    if (costToGo == HUGE_VAL)
+        return 0.0;
+
+    return costToGo;
+}
+
+
+template<int N>
+int
+DoubleIntegrator::System<N>
+::getTrajectory (State<N>& stateFromIn, State<N>& stateToIn, std::list<double*>& trajectoryOut) {
+
+    double cost;
+    double duration = EvaluateDuration (stateFromIn, stateToIn, cost);
+    SampleTrajectory (stateFromIn, stateToIn, duration);
+
+    double c2[N], c3[N];
+    EvaluateCoefficients (stateFromIn, stateToIn, duration, c2, c3);
+
+    for (int k = 1; k < numTrajectorySamples; k++) {
+
+        double t = trajectoryTimes[k];
+        double *stateArr = new double[2*N];
+        for (int i = 0; i < N; i++) {
+            stateArr[i] = trajectoryPositions[i*numTrajectorySamples + k];
+            stateArr[N+i] = stateFromIn.x[N+i] + t*(2.0*c2[i] + 3.0*c3[i]*t);
+        }
+        trajectoryOut.push_back (stateArr);
+    }
+
+    return 1;
+}
+
+
+template<int N>
+bool
+DoubleIntegrator::System<N>
+::isBlockedByObstacleUpdate (State<N>& stateFromIn, State<N>& stateToIn) {
+
+    double cost;
+    double duration = EvaluateDuration (stateFromIn, stateToIn, cost);
+    if (SampleTrajectory (stateFromIn, stateToIn, duration) <= 0)
+        return true;
+
+    double stateFrom[N], stateTo[N];
+    for (int k = 0; k < numTrajectorySamples - 1; k++) {
+
+        for (int i = 0; i < N; i++) {
+            stateFrom[i] = trajectoryPositions[i*numTrajectorySamples + k];
+            stateTo[i] = trajectoryPositions[i*numTrajectorySamples + k + 1];
+        }
+
+        if (IsBlockedByObstacleUpdate (stateFrom, stateTo))
+            return true;
+    }
+
+    return false;
+}
+
+
+template<int N>
+bool
+DoubleIntegrator::System<N>
+::isNearFreedRegion (State<N>& stateIn, double keyRadiusIn) {
+
+    return IsNearFreedRegion (stateIn.x.data(), keyRadiusIn);
+}
+
+
+#endif
@@ -0,0 +1,482 @@
+#include "system_occupancy_grid.h"
+#include "passage_sampler.h"
+#include <cmath>
+#include <cstdlib>
+#include <cctype>
+
+#include <fstream>
+
+using namespace std;
+using namespace SingleIntegrator;
+
+#define GRID_WORD_BITS 64
+
+
+// Reads the next number of a PGM header, skipping white space and comments
+static bool readPgmHeaderValue (ifstream& fileIn, int& valueOut) {
+
+    int c = fileIn.get();
+    while (fileIn.good()) {
+        if (c == '#') {
+            while ( fileIn.good() && (c != '\n') )
+                c = fileIn.get();
+        }
+        else if (!isspace(c))
+            break;
+        c = fileIn.get();
+    }
+
+    if (!fileIn.good() || !isdigit(c))
+        return false;
+
+    valueOut = 0;
+    while ( fileIn.good() && isdigit(c) ) {
+        valueOut = 10*valueOut + (c - '0');
+        c = fileIn.get();
+    }
+
+    // A single white space character separates the header from the binary data
+    return true;
+}
+
+
+OccupancyGridSystem::OccupancyGridSystem () {
+
+    numDimensions = 2;
+
+    numCols = 0;
+    numRows = 0;
+    numWordsPerRow = 0;
+    resolution = 1.0;
+    origin[0] = 0.0;
+    origin[1] = 0.0;
+
+    rootState.setNumDimensions (numDimensions);
+
+    maxExtensionLength = HUGE_VAL;
+
+    sampler.setNumDimensions (numDimensions);
+
+    gaussianSamplingRatio = 0.0;
+    bridgeSamplingRatio = 0.0;
+    narrowPassageDeviation = 1.0;
+
+    regionOperating.setNumDimensions (numDimensions);
+    regionGoal.setNumDimensions (numDimensions);
+    for (int i = 0; i < numDimensions; i++) {
+        regionOperating.center[i] = 0.0;
+        regionOperating.size[i] = 0.0;
+        regionGoal.center[i] = 0.0;
+        regionGoal.size[i] = 0.0;
+    }
+}
+
+
+OccupancyGridSystem::~OccupancyGridSystem () {
+
+}
+
+
+int OccupancyGridSystem::setMapSize (int numColsIn, int numRowsIn, double resolutionIn, double *originIn) {
+
+    if ( (numColsIn <= 0) || (numRowsIn <= 0) || (resolutionIn <= 0.0) )
+        return 0;
+
+    numCols = numColsIn;
+    numRows = numRowsIn;
+    numWordsPerRow = (numCols + GRID_WORD_BITS - 1)/GRID_WORD_BITS;
+    resolution = resolutionIn;
+    origin[0] = originIn[0];
+    origin[1] = originIn[1];
+
+    cells.assign (numWordsPerRow*numRows, 0);
+
+    regionOperating.size[0] = numCols*resolution;
+    regionOperating.size[1] = numRows*resolution;
+    regionOperating.center[0] = origin[0] + regionOperating.size[0]/2.0;
+    regionOperating.center[1] = origin[1] + regionOperating.size[1]/2.0;
+
+    return 1;
+}
+
+
+int OccupancyGridSystem::loadMap (const char *fileNameIn, double resolutionIn, double *originIn, double occupiedThresholdIn) {
+
+    ifstream fileIn (fileNameIn, ios::in | ios::binary);
+    if (!fileIn.is_open())
+        return 0;
+
+    char magic[2];
+    fileIn.read (magic, 2);
+    if ( !fileIn.good() || (magic[0] != 'P') || ( (magic[1] != '2') && (magic[1] != '5') ) )
+        return 0;
+    bool binary = (magic[1] == '5');
+
+    int width, height, maxValue;
+    if ( !readPgmHeaderValue (fileIn, width) || !readPgmHeaderValue (fileIn, height)
+         || !readPgmHeaderValue (fileIn, maxValue) || (maxValue <= 0) || (maxValue > 65535) )
+        return 0;
+
+    if ( (width <= 0) || (height <= 0) )
+        return 0;
+
+    // Read the pixels into a separate grid so that a failed load keeps the current map
+    int numWordsPerRowNew = (width + GRID_WORD_BITS - 1)/GRID_WORD_BITS;
+    vector<uint64_t> cellsNew (numWordsPerRowNew*height, 0);
+
+    for (int imageRow = 0; imageRow < height; imageRow++) {
+        for (int col = 0; col < width; col++) {
+
+            int value;
+            if (binary) {
+                value = fileIn.get();
+                if (maxValue > 255)
+                    value = (value << 8) | fileIn.get();
+            }
+            else
+                fileIn >> value;
+
+            // The last value of a plain map may end the file, which only sets eofbit
+            if (fileIn.fail())
+                return 0;
+
+            double darkness = (double)(maxValue - value)/maxValue;
+            if (darkness > occupiedThresholdIn) {
+                int row = height - 1 - imageRow;
+                cellsNew[row*numWordsPerRowNew + col/GRID_WORD_BITS] |= (uint64_t)1 << (col%GRID_WORD_BITS);
+            }
+        }
+    }
+
+    if (!setMapSize (width, height, resolutionIn, originIn))
+        return 0;
+    cells.swap (cellsNew);
+
+    return 1;
+}
+
+
+bool OccupancyGridSystem::isCellOccupied (int col, int row) {
+
+    if ( (col < 0) || (col >= numCols) || (row < 0) || (row >= numRows) )
+        return true;
+
+    return (cells[row*numWordsPerRow + col/GRID_WORD_BITS] >> (col%GRID_WORD_BITS)) & 1;
+}
+
+
+int OccupancyGridSystem::setCellOccupied (int col, int row, bool occupiedIn) {
+
+    if ( (col < 0) || (col >= numCols) || (row < 0) || (row >= numRows) )
+        return 0;
+
+    uint64_t bit = (uint64_t)1 << (col%GRID_WORD_BITS);
+    if (occupiedIn)
+        cells[row*numWordsPerRow + col/GRID_WORD_BITS] |= bit;
+    else
+        cells[row*numWordsPerRow + col/GRID_WORD_BITS] &= ~bit;
+
+    return 1;
+}
+
+
+int OccupancyGridSystem::getStateKey (State& stateIn, double* stateKey) {
+
+    for (int i = 0; i < numDimensions; i++)
+        stateKey[i] =  stateIn.x[i] / regionOperating.size[i];
+
+    return 1;
+}
+
+
+bool OccupancyGridSystem::isReachingTarget (State &stateIn) {
+
+    for (int i = 0; i < numDimensions; i++) {
+
+        if (fabs(stateIn.x[i] - regionGoal.center[i]) > regionGoal.size[i]/2.0 )
+            return false;
+    }
+
+    return true;
+}
+
+
+bool OccupancyGridSystem::IsRowOccupied (int row, int colFrom, int colTo) {
+
+    const uint64_t *rowCells = &cells[row*numWordsPerRow];
+
+    int wordFrom = colFrom/GRID_WORD_BITS;
+    int wordTo = colTo/GRID_WORD_BITS;
+
+    // Masks of the bits from colFrom to the end of its word and from the start of the word of colTo to colTo
+    uint64_t maskFrom = ~(uint64_t)0 << (colFrom%GRID_WORD_BITS);
+    uint64_t maskTo = ~(uint64_t)0 >> (GRID_WORD_BITS - 1 - colTo%GRID_WORD_BITS);
+
+    if (wordFrom == wordTo)
+        return (rowCells[wordFrom] & maskFrom & maskTo) != 0;
+
+    if (rowCells[wordFrom] & maskFrom)
+        return true;
+    for (int word = wordFrom + 1; word < wordTo; word++)
+        if (rowCells[word])
+            return true;
+
+    return (rowCells[wordTo] & maskTo) != 0;
+}
+
+
+bool OccupancyGridSystem::IsInCollision (double *stateIn) {
+
+    double colCurr = floor ((stateIn[0] - origin[0])/resolution);
+    double rowCurr = floor ((stateIn[1] - origin[1])/resolution);
+
+    if ( !(colCurr >= 0.0) || (colCurr >= numCols) || !(rowCurr >= 0.0) || (rowCurr >= numRows) )
+        return true;
+
+    return isCellOccupied ((int)colCurr, (int)rowCurr);
+}
+
+
+bool OccupancyGridSystem::IsInCollision (double *stateFromIn, double *stateToIn) {
+
+    // Both end points inside the map, so the whole segment is inside
+    if (IsInCollision (stateFromIn) || IsInCollision (stateToIn))
+        return true;
+
+    // Grid coordinates, ordered by increasing row
+    double xFrom = (stateFromIn[0] - origin[0])/resolution;
+    double yFrom = (stateFromIn[1] - origin[1])/resolution;
+    double xTo = (stateToIn[0] - origin[0])/resolution;
+    double yTo = (stateToIn[1] - origin[1])/resolution;
+    if (yFrom > yTo) {
+        double tmp = xFrom;
+        xFrom = xTo;
+        xTo = tmp;
+        tmp = yFrom;
+        yFrom = yTo;
+        yTo = tmp;
+    }
+
+    int rowFrom = (int)floor (yFrom);
+    int rowTo = (int)floor (yTo);
+
+    // Visit the run of cells crossed by the segment in every row
+    for (int row = rowFrom; row <= rowTo; row++) {
+
+        double xLo = xFrom;
+        double xHi = xTo;
+        if (yTo > yFrom) {
+            double slope = (xTo - xFrom)/(yTo - yFrom);
+            double yLo = (row > yFrom) ? row : yFrom;
+            double yHi = (row + 1 < yTo) ? row + 1 : yTo;
+            xLo = xFrom + (yLo - yFrom)*slope;
+            xHi = xFrom + (yHi - yFrom)*slope;
+        }
+        if (xLo > xHi) {
+            double tmp = xLo;
+            xLo = xHi;
+            xHi = tmp;
+        }
+
+        int colFrom = (int)floor (xLo);
+        int colTo = (int)floor (xHi);
+        if (colFrom < 0)
+            colFrom = 0;
+        if (colTo > numCols - 1)
+            colTo = numCols - 1;
+
+        if (IsRowOccupied (row, colFrom, colTo))
+            return true;
+    }
+
+    return false;
+}
+
+
+int OccupancyGridSystem::RGD (State &stateInOut) {
+
+    int numSteps = 100;
+    double stepSize = 0.05;
+
+    for (int n = 0; n < numSteps; n++) {
+
+        if (isReachingTarget (stateInOut))
+            return 1;
+
+        // Step each coordinate towards the goal, stopping before an occupied cell
+        State stateNext (stateInOut);
+        for (int i = 0; i < numDimensions; i++) {
+            if (stateInOut.x[i] > regionGoal.center[i])
+                stateNext.x[i] -= stepSize;
+            else if (stateInOut.x[i] < regionGoal.center[i])
+                stateNext.x[i] += stepSize;
+        }
+
+        if (IsInCollision (stateNext.x))
+            return 1;
+
+        stateInOut = stateNext;
+    }
+
+    return 1;
+}
+
+
+int OccupancyGridSystem::sampleState (State &randomStateOut) {
+
+    randomStateOut.setNumDimensions (numDimensions);
+
+    sampler.samplePoint (randomStateOut.x);
+    for (int i = 0; i < numDimensions; i++) {
+
+        randomStateOut.x[i] = randomStateOut.x[i]*regionOperating.size[i]
+        - regionOperating.size[i]/2.0 + regionOperating.center[i];
+    }
+
+    // Place some of the samples near the occupied cells instead, the cells outside the map are occupied
+    if ( (gaussianSamplingRatio > 0.0) || (bridgeSamplingRatio > 0.0) ) {
+        double strategy = sampler.sampleUniform ();
+        if (strategy < gaussianSamplingRatio)
+            return RRTstar::sampleGaussian (*this, &OccupancyGridSystem::IsInCollision, sampler, randomStateOut.x, numDimensions, narrowPassageDeviation);
+        if (strategy < gaussianSamplingRatio + bridgeSamplingRatio)
+            return RRTstar::sampleBridge (*this, &OccupancyGridSystem::IsInCollision, sampler, randomStateOut.x, numDimensions, narrowPassageDeviation);
+    }
+
+    if (IsInCollision (randomStateOut.x))
+        return 0;
+
+    RGD (randomStateOut);
+
+    return 1;
+}
+
+
+int OccupancyGridSystem::setNarrowPassageSampling (double gaussianRatioIn, double bridgeRatioIn, double deviationIn) {
+
+    if ( (gaussianRatioIn < 0.0) || (bridgeRatioIn < 0.0) || (gaussianRatioIn + bridgeRatioIn > 1.0) || (deviationIn <= 0.0) )
+        return 0;
+
+    gaussianSamplingRatio = gaussianRatioIn;
+    bridgeSamplingRatio = bridgeRatioIn;
+    narrowPassageDeviation = deviationIn;
+
+    return 1;
+}
+
+
+int OccupancyGridSystem::sampleGoalState (State &randomStateOut) {
+
+    return sampleGoalState (randomStateOut, sampler);
+}
+
+
+int OccupancyGridSystem::sampleGoalState (State &randomStateOut, RRTstar::Sampler &samplerIn) {
+
+    randomStateOut.setNumDimensions (numDimensions);
+
+    for (int i = 0; i < numDimensions; i++) {
+
+        randomStateOut.x[i] = samplerIn.sampleUniform ()*regionGoal.size[i]
+        - regionGoal.size[i]/2.0 + regionGoal.center[i];
+    }
+
+    if (IsInCollision (randomStateOut.x))
+        return 0;
+
+    return 1;
+}
+
+
+int OccupancyGridSystem::setMaxExtensionLength (double maxExtensionLengthIn) {
+
+    if (maxExtensionLengthIn <= 0.0)
+        return 0;
+
+    maxExtensionLength = maxExtensionLengthIn;
+
+    return 1;
+}
+
+
+int OccupancyGridSystem::steerState (State &stateFromIn, State &stateTowardsInOut) {
+
+    double distTotal = 0.0;
+    for (int i = 0; i < numDimensions; i++) {
+        double distCurr = stateTowardsInOut.x[i] - stateFromIn.x[i];
+        distTotal += distCurr*distCurr;
+    }
+    distTotal = sqrt (distTotal);
+
+    if (distTotal <= maxExtensionLength)
+        return 1;
+
+    double ratio = maxExtensionLength/distTotal;
+    for (int i = 0; i < numDimensions; i++)
+        stateTowardsInOut.x[i] = stateFromIn.x[i] + (stateTowardsInOut.x[i] - stateFromIn.x[i])*ratio;
+
+    return 1;
+}
+
+
+int OccupancyGridSystem::extendTo (State &stateFromIn, State &stateTowardsIn, Trajectory &trajectoryOut, bool &exactConnectionOut) {
+
+    if (IsInCollision (stateFromIn.x, stateTowardsIn.x))
+        return 0;
+
+    double distTotal = 0.0;
+    for (int i = 0; i < numDimensions; i++) {
+        double distCurr = stateTowardsIn.x[i] - stateFromIn.x[i];
+        distTotal += distCurr*distCurr;
+    }
+
+    if (trajectoryOut.endState)
+        *(trajectoryOut.endState) = stateTowardsIn;
+    else
+        trajectoryOut.endState = new State (stateTowardsIn);
+    trajectoryOut.totalVariation = sqrt (distTotal);
+
+    exactConnectionOut = true;
+
+    return 1;
+}
+
+
+double OccupancyGridSystem::evaluateExtensionCost (State& stateFromIn, State& stateTowardsIn, bool &exactConnectionOut) {
+
+    exactConnectionOut = true;
+
+    double distTotal = 0.0;
+    for (int i = 0; i < numDimensions; i++) {
+        double distCurr = stateTowardsIn.x[i] - stateFromIn.x[i];
+        distTotal += distCurr*distCurr;
+    }
+
+    return sqrt(distTotal);
+}
+
+
+int OccupancyGridSystem::getTrajectory (State& stateFromIn, State& stateToIn, list<double*>& trajectoryOut) {
+
+    double *stateArr = new double[numDimensions];
+    for (int i = 0; i < numDimensions; i++)
+        stateArr[i] = stateToIn[i];
+    trajectoryOut.push_front (stateArr);
+
+    return 1;
+}
+
+
+double OccupancyGridSystem::evaluateCostToGo (State& stateIn) {
+
+    double radius = 0.0;
+    for (int i = 0; i < numDimensions; i++)
+        radius += regionGoal.size[i] * regionGoal.size[i];
+    radius = sqrt(radius);
+
+    double dist = 0.0;
+    for (int i = 0; i < numDimensions; i++)
+        dist += (stateIn[i] - regionGoal.center[i])*(stateIn[i] - regionGoal.center[i]);
+    dist = sqrt(dist);
+
+    return dist - radius;
+}
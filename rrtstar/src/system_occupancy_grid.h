@@ -0,0 +1,334 @@
+/*!
+ * \file system_occupancy_grid.h
+ */
+
+#ifndef __RRTS_SYSTEM_OCCUPANCY_GRID_H_
+#define __RRTS_SYSTEM_OCCUPANCY_GRID_H_
+
+#include <list>
+#include <vector>
+
+#include <stdint.h>
+
+#include "system_single_integrator.h"
+
+
+
+namespace SingleIntegrator {
+
+
+    /*!
+     * \brief Single integrator system in a two dimensional occupancy grid.
+     *
+     * The environment is a grid of square cells instead of a list of obstacle
+     * boxes. The occupancy is stored with one bit per cell, 64 cells per word.
+     * An edge is valid if none of the cells it passes through is occupied: the
+     * cells crossed by the edge form one run of consecutive cells per row,
+     * and each run is tested a word at a time. The map is static, so the
+     * system does not support Planner::updateObstacles.
+     */
+    class OccupancyGridSystem {
+
+        int numDimensions;
+
+        int numCols;
+        int numRows;
+        int numWordsPerRow;
+        double resolution;
+        double origin[2];
+
+        // Occupancy bits, row after row, bit col%64 of word col/64 of the row
+        std::vector<uint64_t> cells;
+
+        bool IsInCollision (double *stateIn);
+        bool IsInCollision (double *stateFromIn, double *stateToIn);
+        bool IsRowOccupied (int row, int colFrom, int colTo);
+
+        State rootState;
+
+        double maxExtensionLength;
+
+        RRTstar::Sampler sampler;
+
+        double gaussianSamplingRatio;
+        double bridgeSamplingRatio;
+        double narrowPassageDeviation;
+
+        int RGD (State &stateInOut);
+
+    public:
+
+        /*!
+         * \brief The operating region, set to the extent of the map
+         *
+         * More elaborate description
+         */
+        region regionOperating;
+
+        /*!
+         * \brief The goal region
+         *
+         * More elaborate description
+         */
+        region regionGoal;
+
+        /*!
+         * \brief OccupancyGridSystem constructor
+         *
+         * More elaborate description
+         */
+        OccupancyGridSystem ();
+
+        /*!
+         * \brief OccupancyGridSystem destructor
+         *
+         * More elaborate description
+         */
+        ~OccupancyGridSystem ();
+
+        /*!
+         * \brief Creates an empty map
+         *
+         * Sets the operating region to the extent of the map.
+         *
+         * \param numColsIn Number of cells along the first axis
+         * \param numRowsIn Number of cells along the second axis
+         * \param resolutionIn Edge length of a cell
+         * \param originIn Coordinates of the corner of cell (0, 0), an array of dimension 2
+         *
+         */
+        int setMapSize (int numColsIn, int numRowsIn, double resolutionIn, double *originIn);
+
+        /*!
+         * \brief Loads the map from a PGM (P2 or P5) image
+         *
+         * The first image row is the row with the largest second coordinate.
+         * A pixel is occupied if its darkness, (maxval - value)/maxval, exceeds
+         * the threshold. Sets the operating region to the extent of the map.
+         * Returns 0 and keeps the current map if the file can not be read.
+         *
+         * \param fileNameIn Name of the image file
+         * \param resolutionIn Edge length of a cell
+         * \param originIn Coordinates of the corner of the bottom left pixel, an array of dimension 2
+         * \param occupiedThresholdIn Darkness above which a pixel is occupied, in [0,1]
+         *
+         */
+        int loadMap (const char *fileNameIn, double resolutionIn, double *originIn, double occupiedThresholdIn);
+
+        /*!
+         * \brief Returns true if the cell is occupied
+         *
+         * Cells outside the map are occupied.
+         *
+         * \param col Column of the cell
+         * \param row Row of the cell
+         *
+         */
+        bool isCellOccupied (int col, int row);
+
+        /*!
+         * \brief Marks the cell as occupied or free
+         *
+         * More elaborate description
+         *
+         * \param col Column of the cell
+         * \param row Row of the cell
+         * \param occupiedIn The new occupancy of the cell
+         *
+         */
+        int setCellOccupied (int col, int row, bool occupiedIn);
+
+        /*!
+         * \brief Returns the dimensionality of the Euclidean space.
+         *
+         * A more elaborate description.
+         */
+        int getNumDimensions () {return numDimensions;}
+
+        /*!
+         * \brief Returns the sampler that draws the sample states
+         *
+         * Seed it or change its sequence to reproduce runs or to give each
+         * planner its own stream.
+         */
+        RRTstar::Sampler& getSampler () {return sampler;}
+
+        /*!
+         * \brief Returns a reference to the root state.
+         *
+         * A more elaborate description.
+         */
+        State& getRootState () {return rootState;}
+
+        /*!
+         * \brief Sets the root state.
+         *
+         * A more elaborate description.
+         */
+        int setRootState (State& stateIn) {rootState = stateIn; return 1;}
+
+        /*!
+         * \brief Returns the statekey for the given state.
+         *
+         * A more elaborate description.
+         *
+         * \param stateIn the given state
+         * \param stateKey the key to the state. An array of dimension getNumDimensions()
+         *
+         */
+        int getStateKey (State &stateIn, double *stateKey);
+
+        /*!
+         * \brief Returns true of the given state reaches the target.
+         *
+         * A more elaborate description.
+         */
+        bool isReachingTarget (State &stateIn);
+
+        /*!
+         * \brief Returns a sample state, moved towards the goal by randomized gradient descent.
+         *
+         * A more elaborate description.
+         *
+         * \param randomStateOut
+         *
+         */
+        int sampleState (State &randomStateOut);
+
+        /*!
+         * \brief Returns a sample state from the goal region.
+         *
+         * A more elaborate description.
+         *
+         * \param randomStateOut
+         *
+         */
+        int sampleGoalState (State &randomStateOut);
+
+        /*!
+         * \brief Returns a sample state from the goal region, drawn with the given sampler.
+         *
+         * Does not touch the sampler of the system.
+         *
+         * \param randomStateOut
+         * \param samplerIn The sampler that draws the state
+         *
+         */
+        int sampleGoalState (State &randomStateOut, RRTstar::Sampler &samplerIn);
+
+        /*!
+         * \brief Sets the fractions of the samples drawn near the obstacles
+         *
+         * A fraction of the samples is drawn with Gaussian sampling, which keeps
+         * points next to the obstacle boundaries, and a fraction with the bridge
+         * test, which keeps midpoints between two blocked points and so favors
+         * narrow passages. These samples are not moved by RGD. The rest of the
+         * samples are uniform. The default fractions are zero.
+         *
+         * \param gaussianRatioIn Fraction of Gaussian samples
+         * \param bridgeRatioIn Fraction of bridge test samples
+         * \param deviationIn Standard deviation of the distance between the paired points
+         *
+         */
+        int setNarrowPassageSampling (double gaussianRatioIn, double bridgeRatioIn, double deviationIn);
+
+        /*!
+         * \brief Sets the maximum length of an extension
+         *
+         * The default is HUGE_VAL, i.e., samples are connected at any distance.
+         *
+         * \param maxExtensionLengthIn The new maximum length, larger than zero
+         *
+         */
+        int setMaxExtensionLength (double maxExtensionLengthIn);
+
+        /*!
+         * \brief Returns the maximum length of an extension
+         *
+         * A more elaborate description.
+         */
+        double getMaxExtensionLength () {return maxExtensionLength;}
+
+        /*!
+         * \brief Moves stateTowardsInOut along the straight line towards stateFromIn until
+         *        it is within the maximum extension length of stateFromIn.
+         *
+         * A more elaborate description.
+         *
+         * \param stateFromIn The state to steer from
+         * \param stateTowardsInOut The state to be truncated
+         *
+         */
+        int steerState (State &stateFromIn, State &stateTowardsInOut);
+
+        /*!
+         * \brief Returns a the cost of the trajectory that connects stateFromIn and
+         *        stateTowardsIn. The trajectory is also returned in trajectoryOut.
+         *
+         * A more elaborate description.
+         *
+         * \param stateFromIn Initial state
+         * \param stateTowardsIn Final state
+         * \param trajectoryOut Trajectory that starts the from the initial state and
+         *                      reaches near the final state.
+         * \param exactConnectionOut Set to true if the initial and the final states
+         *                           can be connected exactly.
+         *
+         */
+        int extendTo (State &stateFromIn, State &stateTowardsIn,
+                      Trajectory &trajectoryOut, bool &exactConnectionOut);
+
+        /*!
+         * \brief Returns the cost of the trajectory that connects stateFromIn and StateTowardsIn.
+         *
+         * A more elaborate description.
+         *
+         * \param stateFromIn Initial state
+         * \param stateTowardsIn Final state
+         * \param exactConnectionOut Set to true if the initial and the final states
+         *                           can be connected exactly.
+         *
+         */
+        double evaluateExtensionCost (State &stateFromIn, State &stateTowardsIn, bool &exactConnectionOut);
+
+        /*!
+         * \brief Returns a lower bound on the cost to go starting from stateIn
+         *
+         * A more elaborate description.
+         *
+         * \param stateIn Starting state
+         *
+         */
+        double evaluateCostToGo (State& stateIn);
+
+        /*!
+         * \brief Returns the trajectory as a list of double arrays, each with dimension getNumDimensions.
+         *
+         * A more elaborate description.
+         *
+         * \param stateFromIn Initial state
+         * \param stateToIn Final state
+         * \param trajectoryOut The list of double arrays that represent the trajectory
+         *
+         */
+        int getTrajectory (State& stateFromIn, State& stateToIn, std::list<double*>& trajectoryOut);
+    };
+}
+
+
+
+
+namespace RRTstar {
+
+
+    // Straight edges are determined by their end states
+    template<>
+    struct SystemTraits<SingleIntegrator::OccupancyGridSystem> {
+        static const bool storeTrajectories = false;
+        static const bool batchCostQueries = false;
+        static const bool batchCollisionQueries = false;
+    };
+}
+
+
+#endif
@@ -1,14 +1,29 @@
 #include "system_single_integrator.h"
+#include "obstacle_bvh.h"
+#include "distance_field.h"
+#include "potential_field.h"
+#include "navigation_field.h"
+#include "edge_validator.h"
+#include "passage_sampler.h"
 #include <cmath>
 #include <cstdlib>
 
 #include <iostream>
 
 using namespace std;
+using namespace RRTstar;
 using namespace SingleIntegrator;
 
+// Smallest step of the discretized collision checker
 #define DISCRETIZATION_STEP 0.01
 
+// Number of steps of the potential field descent, and the range of its step size in cells
+#define RGD_MAX_STEPS 100
+#define RGD_STEP_SIZE_RANGE 16.0
+
+// Largest distance the potential field descent moves a sample, as far as 100 axis steps of 0.05
+#define RGD_MAX_DISPLACEMENT 5.0
+
 
 region::region () {
     
@@ -85,6 +100,7 @@ State& State::operator=(const State &stateIn){
     if (numDimensions != stateIn.numDimensions) {
         if (x) 
             delete [] x;
+        x = NULL;
         numDimensions = stateIn.numDimensions;
         if (numDimensions > 0)
             x = new double[numDimensions];
@@ -97,6 +113,34 @@ State& State::operator=(const State &stateIn){
 }
 
 
+State::State (State &&stateIn) {
+    
+    numDimensions = stateIn.numDimensions;
+    x = stateIn.x;
+    
+    stateIn.numDimensions = 0;
+    stateIn.x = NULL;
+}
+
+
+State& State::operator=(State &&stateIn) {
+    
+    if (this == &stateIn) 
+        return *this;
+    
+    if (x) 
+        delete [] x;
+    
+    numDimensions = stateIn.numDimensions;
+    x = stateIn.x;
+    
+    stateIn.numDimensions = 0;
+    stateIn.x = NULL;
+    
+    return *this;
+}
+
+
 int State::setNumDimensions (int numDimensionsIn) {
     
     if (x)
@@ -131,6 +175,7 @@ Trajectory::Trajectory (const Trajectory &trajectoryIn) {
     
     endState = new State (trajectoryIn.getEndState()); 
 
+    totalVariation = trajectoryIn.totalVariation;
 }
 
 
@@ -139,14 +184,40 @@ Trajectory& Trajectory::operator=(const Trajectory &trajectoryIn) {
     if (this == &trajectoryIn)
         return *this;
     
+    // Reuse the end state, which keeps its coordinates if the dimensions agree
     if (endState)
-        delete endState;
+        *endState = trajectoryIn.getEndState();
+    else
+        endState = new State (trajectoryIn.getEndState());
     
+    totalVariation = trajectoryIn.totalVariation;
     
-    endState = new State (trajectoryIn.getEndState());
+    return *this;
+}
+
+
+Trajectory::Trajectory (Trajectory &&trajectoryIn) { 
+    
+    endState = trajectoryIn.endState;
+    totalVariation = trajectoryIn.totalVariation;
+    
+    trajectoryIn.endState = NULL;
+}
+
+
+Trajectory& Trajectory::operator=(Trajectory &&trajectoryIn) { 
+
+    if (this == &trajectoryIn)
+        return *this;
+    
+    if (endState)
+        delete endState;
     
+    endState = trajectoryIn.endState;
     totalVariation = trajectoryIn.totalVariation;
     
+    trajectoryIn.endState = NULL;
+    
     return *this;
 }
 
@@ -160,11 +231,87 @@ double Trajectory::evaluateCost () {
 System::System () {
     
     numDimensions = 0;
+    
+    collisionCheckingMode = COLLISION_CHECKING_ANALYTIC;
+    
+    obstacleBVH = new ObstacleBVH;
+    distanceField = new DistanceField;
+    distanceFieldResolution = 1.0;
+    discretizationStep = DISCRETIZATION_STEP;
+    obstacleIndexDirty = true;
+    
+    rgdMode = RGD_AXIS_STEPS;
+    potentialField = new PotentialField;
+    potentialFieldResolution = 1.0;
+    potentialFieldInfluenceDistance = 5.0;
+    potentialFieldRepulsiveGain = 1.0;
+    resetRGDStatistics ();
+    
+    gaussianSamplingRatio = 0.0;
+    bridgeSamplingRatio = 0.0;
+    narrowPassageDeviation = 1.0;
+    
+    costToGoMode = COST_TO_GO_EUCLIDEAN;
+    navigationFieldGoal = new NavigationField;
+    navigationFieldRoot = new NavigationField;
+    navigationFieldResolution = 1.0;
+    corridorSamplingRatio = 0.0;
+    corridorSlack = 0.0;
+    
+    maxExtensionLength = HUGE_VAL;
 }
 
 
 System::~System () {
     
+    clearObstacleUpdates ();
+    
+    delete obstacleBVH;
+    delete distanceField;
+    delete potentialField;
+    delete navigationFieldGoal;
+    delete navigationFieldRoot;
+}
+
+
+int System::updateObstacleIndex () {
+    
+    obstacleBVH->build (obstacles, numDimensions);
+    
+    // Check edges at half the smallest obstacle extent, but not finer than DISCRETIZATION_STEP
+    discretizationStep = HUGE_VAL;
+    for (list<region*>::iterator iter = obstacles.begin(); iter != obstacles.end(); iter++) 
+        for (int i = 0; i < numDimensions; i++) 
+            if ((*iter)->size[i]/2.0 < discretizationStep)
+                discretizationStep = (*iter)->size[i]/2.0;
+    if (discretizationStep < DISCRETIZATION_STEP)
+        discretizationStep = DISCRETIZATION_STEP;
+    
+    if (collisionCheckingMode == COLLISION_CHECKING_DISTANCE_FIELD)
+        distanceField->build (regionOperating, obstacles, numDimensions, distanceFieldResolution);
+    
+    list<region*> regionsGoal;
+    GetGoalRegions (regionsGoal);
+    
+    // The potential field shares the distance field of the collision checker at the same resolution
+    if (rgdMode == RGD_POTENTIAL_FIELD) {
+        DistanceField *distanceFieldShared = NULL;
+        if (collisionCheckingMode == COLLISION_CHECKING_DISTANCE_FIELD)
+            distanceFieldShared = distanceField;
+        potentialField->build (regionOperating, regionsGoal, obstacles, numDimensions, potentialFieldResolution, 
+                               potentialFieldInfluenceDistance, potentialFieldRepulsiveGain, distanceFieldShared);
+    }
+    
+    if ( (costToGoMode == COST_TO_GO_NAVIGATION_FIELD) || (corridorSamplingRatio > 0.0) ) 
+        navigationFieldGoal->build (regionOperating, obstacles, regionsGoal, numDimensions, navigationFieldResolution);
+    
+    corridorCells.clear ();
+    if (corridorSamplingRatio > 0.0) 
+        updateCorridor ();
+    
+    obstacleIndexDirty = false;
+    
+    return 1;
 }
 
 
@@ -177,6 +324,8 @@ int System::setNumDimensions (int numDimensionsIn) {
     
     rootState.setNumDimensions (numDimensions);
     
+    sampler.setNumDimensions (numDimensions);
+    
     return 1;
 }
 
@@ -193,76 +342,175 @@ int System::getStateKey (State& stateIn, double* stateKey) {
 
 bool System::isReachingTarget (State &stateIn) {
     
+    if (IsInRegion (stateIn.x, regionGoal))
+        return true;
     
-    for (int i = 0; i < numDimensions; i++) {
-        
-        if (fabs(stateIn.x[i] - regionGoal.center[i]) > regionGoal.size[i]/2.0 )  
-            return false;
-    }
+    for (list<region*>::iterator iter = goalRegions.begin(); iter != goalRegions.end(); iter++) 
+        if (IsInRegion (stateIn.x, **iter))
+            return true;
     
-    return true;
+    return false;
 }
 
 
 bool System::IsInCollision (double *stateIn) {
     
-    for (list<region*>::iterator iter = obstacles.begin(); iter != obstacles.end(); iter++) { 
+    if ( obstacleIndexDirty || (obstacleBVH->getNumObstacles() != (int)obstacles.size()) )
+        updateObstacleIndex ();
+    
+    // Cells with a positive distance do not overlap any obstacle
+    if ( (collisionCheckingMode == COLLISION_CHECKING_DISTANCE_FIELD) && (distanceField->getSignedDistance (stateIn) > 0.0) )
+        return false;
+    
+    return obstacleBVH->isInCollision (stateIn);
+} 
+
+
+bool System::IsInRegion (double *stateFromIn, double *stateToIn, region &regionIn) {
+    
+    // Slab test: clip the parameter interval of the segment against each dimension of the box
+    double tMin = 0.0;
+    double tMax = 1.0;
+    
+    for (int i = 0; i < numDimensions; i++) {
         
-        region *obstacleCurr = *iter;
-        bool collisionFound = true;
+        double lo = regionIn.center[i] - regionIn.size[i]/2.0;
+        double hi = regionIn.center[i] + regionIn.size[i]/2.0;
+        double dist = stateToIn[i] - stateFromIn[i];
         
-        for (int i = 0; i < numDimensions; i++) 
-            if (fabs(obstacleCurr->center[i] - stateIn[i]) > obstacleCurr->size[i]/2.0 ) {
-                collisionFound = false;
-                break;
-            }
+        if (fabs(dist) < 1e-12) {
+            if ( (stateFromIn[i] < lo) || (stateFromIn[i] > hi) )
+                return false;
+            continue;
+        }
         
-        if (collisionFound) {
-            return true;
+        double t1 = (lo - stateFromIn[i])/dist;
+        double t2 = (hi - stateFromIn[i])/dist;
+        if (t1 > t2) {
+            double tmp = t1;
+            t1 = t2;
+            t2 = tmp;
         }
+        
+        if (t1 > tMin)
+            tMin = t1;
+        if (t2 < tMax)
+            tMax = t2;
+        if (tMin > tMax)
+            return false;
     }
     
-    return false;
-} 
+    return true;
+}
+
+
+bool System::IsInRegion (double *stateIn, region &regionIn) {
+    
+    for (int i = 0; i < numDimensions; i++) 
+        if (fabs(stateIn[i] - regionIn.center[i]) > regionIn.size[i]/2.0)  
+            return false;
+    
+    return true;
+}
+
+
+double System::EvaluateDistanceToRegion (double *stateIn, region &regionIn) {
+    
+    // Distance to the center less the diagonal of the region
+    double radius = 0.0;
+    for (int i = 0; i < numDimensions; i++) 
+        radius += regionIn.size[i] * regionIn.size[i];
+    radius = sqrt(radius);
+    
+    double dist = 0.0;
+    for (int i = 0; i < numDimensions; i++) 
+        dist += (stateIn[i] - regionIn.center[i])*(stateIn[i] - regionIn.center[i]); 
+    dist = sqrt(dist);
+    
+    return dist - radius;
+}
+
+
+int System::GetGoalRegions (list<region*>& regionsOut) {
+    
+    regionsOut.clear ();
+    regionsOut.push_back (&regionGoal);
+    for (list<region*>::iterator iter = goalRegions.begin(); iter != goalRegions.end(); iter++) 
+        regionsOut.push_back (*iter);
+    
+    return regionsOut.size();
+}
 
 
 int System::RGD(State &rstout) {
  
+   if (rgdMode == RGD_POTENTIAL_FIELD)
+       return RGDPotentialField (rstout);
+ 
+   // Descend towards the center of the nearest goal region
+   region *regionTarget = &regionGoal;
+   if (!goalRegions.empty()) {
+       double distTarget = EvaluateDistanceToRegion (rstout.x, regionGoal);
+       for (list<region*>::iterator iter = goalRegions.begin(); iter != goalRegions.end(); iter++) {
+           double distCurr = EvaluateDistanceToRegion (rstout.x, **iter);
+           if (distCurr < distTarget) {
+               regionTarget = *iter;
+               distTarget = distCurr;
+           }
+       }
+   }
+   region& regionDescent = *regionTarget;
+ 
    int k = 100; 
    double lamda = 0.05; //lamda step size
    State& previous_state = rstout;
+   numRGDSamples++;
+   bool moved = false;
    for(int n = 0; n<k; n++)
     {
       if(IsInCollision(rstout.x))
 	{
           rstout = previous_state;
+	  numRGDSamplesStopped++;
+	  if (moved)
+	      numRGDSamplesMoved++;
 	  return 1;
 
 	 }
 
+      bool stepped = false;
+
 	for(int j = 0; j<numDimensions; j++)
  	 {
 		//Find out the direction of goal w.r.t sample or vice versa	
-	 if(rstout.x[j] - regionGoal.center[j] > 0) 
+	 if(rstout.x[j] - regionDescent.center[j] > 0) 
           {	//as Potential is zero in goal region
 		  if(isReachingTarget(rstout) == false)
 		    {	 				
 			previous_state = rstout;
 			rstout.x[j] = rstout.x[j] - lamda;
+			stepped = true;
 	  	    }
-	  }else if(rstout.x[j] - regionGoal.center[j] < 0) 
+	  }else if(rstout.x[j] - regionDescent.center[j] < 0) 
 		{   //as Potential is zero in goal region
 		    if(isReachingTarget(rstout) == false) 
 		      {   previous_state = rstout;
 		         rstout.x[j] = rstout.x[j] + lamda;
+		         stepped = true;
 		      }
 
 		}		
 	
 	 }
 	
+      if (!stepped)
+          break;
+      numRGDSteps++;
+      moved = true;
        }
 
+      if (moved)
+          numRGDSamplesMoved++;
       return 1;	
 	 		
      } 
@@ -272,16 +520,225 @@ int System::RGD(State &rstout) {
 
 
 
+int System::setNarrowPassageSampling (double gaussianRatioIn, double bridgeRatioIn, double deviationIn) {
+    
+    if ( (gaussianRatioIn < 0.0) || (bridgeRatioIn < 0.0) || (deviationIn <= 0.0) 
+         || (gaussianRatioIn + bridgeRatioIn + corridorSamplingRatio > 1.0) )
+        return 0;
+    
+    gaussianSamplingRatio = gaussianRatioIn;
+    bridgeSamplingRatio = bridgeRatioIn;
+    narrowPassageDeviation = deviationIn;
+    
+    return 1;
+}
+
+
+int System::setCostToGoMode (int costToGoModeIn) {
+    
+    if ( (costToGoModeIn != COST_TO_GO_EUCLIDEAN) && (costToGoModeIn != COST_TO_GO_NAVIGATION_FIELD) )
+        return 0;
+    
+    costToGoMode = costToGoModeIn;
+    
+    obstacleIndexDirty = true;
+    
+    return 1;
+}
+
+
+int System::setNavigationFieldResolution (double resolutionIn) {
+    
+    if (resolutionIn <= 0.0)
+        return 0;
+    
+    navigationFieldResolution = resolutionIn;
+    
+    obstacleIndexDirty = true;
+    
+    return 1;
+}
+
+
+int System::setCorridorSampling (double ratioIn, double slackIn) {
+    
+    if ( (ratioIn < 0.0) || (slackIn < 0.0) || (gaussianSamplingRatio + bridgeSamplingRatio + ratioIn > 1.0) )
+        return 0;
+    
+    corridorSamplingRatio = ratioIn;
+    corridorSlack = slackIn;
+    
+    obstacleIndexDirty = true;
+    
+    return 1;
+}
+
+
+int System::setRootState (State& stateIn) {
+    
+    rootState = stateIn;
+    
+    if (corridorSamplingRatio > 0.0)
+        obstacleIndexDirty = true;
+    
+    return 1;
+}
+
+
+int System::updateCorridor () {
+    
+    int cellRoot = navigationFieldGoal->getCellIndex (rootState.x);
+    if ( (cellRoot < 0) || (navigationFieldGoal->getCellDistance (cellRoot) == HUGE_VAL) )
+        return 0;
+    
+    region regionRoot;
+    regionRoot.setNumDimensions (numDimensions);
+    for (int i = 0; i < numDimensions; i++) {
+        regionRoot.center[i] = rootState.x[i];
+        regionRoot.size[i] = 0.0;
+    }
+    navigationFieldRoot->build (regionOperating, obstacles, regionRoot, numDimensions, navigationFieldResolution);
+    
+    // Allow for the positions of the root and the goal inside their cells
+    double lengthMax = (1.0 + corridorSlack)*navigationFieldGoal->getCellDistance (cellRoot) 
+        + 2.0*navigationFieldResolution*sqrt ((double)numDimensions);
+    
+    int numCells = navigationFieldGoal->getNumCells ();
+    for (int k = 0; k < numCells; k++) 
+        if (navigationFieldRoot->getCellDistance (k) + navigationFieldGoal->getCellDistance (k) <= lengthMax)
+            corridorCells.push_back (k);
+    
+    return 1;
+}
+
+
+bool System::IsBlocked (double *stateIn) {
+    
+    // The boundary of the operating region acts as an obstacle
+    for (int i = 0; i < numDimensions; i++) 
+        if (fabs (stateIn[i] - regionOperating.center[i]) > regionOperating.size[i]/2.0)
+            return true;
+    
+    return IsInCollision (stateIn);
+}
+
+
+int System::RGDPotentialField (State &stateInOut) {
+    
+    // Start with one cell and adapt the step to the curvature of the potential
+    double stepSize = potentialField->getResolution ();
+    double stepSizeMin = stepSize/RGD_STEP_SIZE_RANGE;
+    double stepSizeMax = stepSize*RGD_STEP_SIZE_RANGE;
+    
+    double potentialCurr = potentialField->getPotential (stateInOut.x);
+    State stateNext (stateInOut);
+    double *gradient = new double[numDimensions];
+    
+    // The descent biases the sample, moving it all the way would collapse the samples into the minima
+    double displacementLeft = RGD_MAX_DISPLACEMENT;
+    
+    numRGDSamples++;
+    bool moved = false;
+    bool stopped = false;
+    
+    for (int n = 0; n < RGD_MAX_STEPS; n++) {
+        
+        if ( isReachingTarget (stateInOut) || (displacementLeft <= 0.0) )
+            break;
+        if (stepSize > displacementLeft)
+            stepSize = displacementLeft;
+        
+        potentialField->getGradient (stateInOut.x, gradient);
+        double gradientNorm = 0.0;
+        for (int i = 0; i < numDimensions; i++) 
+            gradientNorm += gradient[i]*gradient[i];
+        gradientNorm = sqrt (gradientNorm);
+        if (gradientNorm == 0.0)
+            break;
+        
+        for (int i = 0; i < numDimensions; i++) 
+            stateNext.x[i] = stateInOut.x[i] - stepSize*gradient[i]/gradientNorm;
+        
+        // Shrink the step if it does not descend or collides, give up once it is too small
+        double potentialNext = potentialField->getPotential (stateNext.x);
+        bool collides = (potentialNext < potentialCurr)
+            && (potentialField->getClearance (stateNext.x) <= 0.0) && IsInCollision (stateNext.x);
+        if ( (potentialNext >= potentialCurr) || collides ) {
+            stepSize /= 2.0;
+            if (stepSize < stepSizeMin) {
+                stopped = collides;
+                break;
+            }
+            continue;
+        }
+        
+        for (int i = 0; i < numDimensions; i++) 
+            stateInOut.x[i] = stateNext.x[i];
+        potentialCurr = potentialNext;
+        displacementLeft -= stepSize;
+        numRGDSteps++;
+        moved = true;
+        
+        stepSize *= 2.0;
+        if (stepSize > stepSizeMax)
+            stepSize = stepSizeMax;
+    }
+    
+    delete [] gradient;
+    
+    if (moved)
+        numRGDSamplesMoved++;
+    if (stopped)
+        numRGDSamplesStopped++;
+    
+    return 1;
+}
+
+
+int System::resetRGDStatistics () {
+    
+    numRGDSamples = 0;
+    numRGDSteps = 0;
+    numRGDSamplesMoved = 0;
+    numRGDSamplesStopped = 0;
+    
+    return 1;
+}
+
+
 int System::sampleState (State &randomStateOut) {
     
     randomStateOut.setNumDimensions (numDimensions);
     
+    sampler.samplePoint (randomStateOut.x);
     for (int i = 0; i < numDimensions; i++) {
         
-        randomStateOut.x[i] = (double)rand()/(RAND_MAX + 1.0)*regionOperating.size[i] 
+        randomStateOut.x[i] = randomStateOut.x[i]*regionOperating.size[i] 
         - regionOperating.size[i]/2.0 + regionOperating.center[i];
     }
     
+    // Place some of the samples near the obstacles or in the corridor instead
+    if ( (gaussianSamplingRatio > 0.0) || (bridgeSamplingRatio > 0.0) || (corridorSamplingRatio > 0.0) ) {
+        
+        if ( obstacleIndexDirty || (obstacleBVH->getNumObstacles() != (int)obstacles.size()) )
+            updateObstacleIndex ();
+        
+        double strategy = sampler.sampleUniform ();
+        if (strategy < gaussianSamplingRatio)
+            return sampleGaussian (*this, &System::IsBlocked, sampler, randomStateOut.x, numDimensions, narrowPassageDeviation);
+        if (strategy < gaussianSamplingRatio + bridgeSamplingRatio)
+            return sampleBridge (*this, &System::IsBlocked, sampler, randomStateOut.x, numDimensions, narrowPassageDeviation);
+        
+        if ( (strategy < gaussianSamplingRatio + bridgeSamplingRatio + corridorSamplingRatio) && !corridorCells.empty() ) {
+            int cellIndex = corridorCells[(int)(sampler.sampleUniform ()*corridorCells.size())];
+            navigationFieldGoal->getCellCorner (cellIndex, randomStateOut.x);
+            for (int i = 0; i < numDimensions; i++) 
+                randomStateOut.x[i] += sampler.sampleUniform ()*navigationFieldResolution;
+            if (IsBlocked (randomStateOut.x))
+                return 0;
+        }
+    }
+    
     if (IsInCollision (randomStateOut.x))
         return 0;
 
@@ -292,47 +749,209 @@ int System::sampleState (State &randomStateOut) {
 }
 
 
+int System::sampleGoalState (State &randomStateOut) {
+    
+    return sampleGoalState (randomStateOut, sampler);
+}
 
-int System::extendTo (State &stateFromIn, State &stateTowardsIn, Trajectory &trajectoryOut, bool &exactConnectionOut) {
+
+int System::sampleGoalState (State &randomStateOut, RRTstar::Sampler &samplerIn) {
     
-    double *dists = new double[numDimensions];
-    for (int i = 0; i < numDimensions; i++) 
-        dists[i] = stateTowardsIn.x[i] - stateFromIn.x[i];
+    randomStateOut.setNumDimensions (numDimensions);
     
-    double distTotal = 0.0;
-    for (int i = 0; i < numDimensions; i++) 
-        distTotal += dists[i]*dists[i];
-    distTotal = sqrt (distTotal);
+    // Pick one of the goal regions with probability proportional to its volume
+    region *regionSample = &regionGoal;
+    if (!goalRegions.empty()) {
+        
+        list<region*> regionsGoal;
+        GetGoalRegions (regionsGoal);
+        
+        vector<double> volumes;
+        double volumeTotal = 0.0;
+        for (list<region*>::iterator iter = regionsGoal.begin(); iter != regionsGoal.end(); iter++) {
+            double volume = 1.0;
+            for (int i = 0; i < numDimensions; i++) 
+                volume *= (*iter)->size[i];
+            volumes.push_back (volume);
+            volumeTotal += volume;
+        }
+        
+        // Regions without volume are picked with equal probability
+        if (volumeTotal <= 0.0) {
+            volumes.assign (volumes.size(), 1.0);
+            volumeTotal = volumes.size();
+        }
+        
+        double volumeSample = samplerIn.sampleUniform ()*volumeTotal;
+        int index = 0;
+        for (list<region*>::iterator iter = regionsGoal.begin(); iter != regionsGoal.end(); iter++, index++) {
+            regionSample = *iter;
+            volumeSample -= volumes[index];
+            if (volumeSample < 0.0)
+                break;
+        }
+    }
     
-    double incrementTotal = distTotal/DISCRETIZATION_STEP; //DISCRETIZATION_STEP = 0.01 
+    for (int i = 0; i < numDimensions; i++) {
+        
+        randomStateOut.x[i] = samplerIn.sampleUniform ()*regionSample->size[i] 
+        - regionSample->size[i]/2.0 + regionSample->center[i];
+    }
     
-    // normalize the distance according to the disretization step 
-    for (int i = 0; i < numDimensions; i++)
-        dists[i] /= incrementTotal;           
+    if (IsInCollision (randomStateOut.x))
+        return 0;
     
-    int numSegments = (int)floor(incrementTotal);  
+    return 1;
+}
+
+
+
+bool System::IsInCollision (double *stateFromIn, double *stateToIn) {
     
-    double *stateCurr = new double[numDimensions];
-    for (int i = 0; i < numDimensions; i++) 
-        stateCurr[i] = stateFromIn.x[i];   
-   
-    for (int i = 0; i < numSegments; i++) {
+    if ( obstacleIndexDirty || (obstacleBVH->getNumObstacles() != (int)obstacles.size()) )
+        updateObstacleIndex ();
+    
+    if (collisionCheckingMode == COLLISION_CHECKING_ANALYTIC)
+        return obstacleBVH->isInCollision (stateFromIn, stateToIn);
+    
+    if (collisionCheckingMode == COLLISION_CHECKING_DISTANCE_FIELD) {
+        
+        double distTotal = 0.0;
+        for (int i = 0; i < numDimensions; i++) 
+            distTotal += (stateToIn[i] - stateFromIn[i])*(stateToIn[i] - stateFromIn[i]);
+        distTotal = sqrt (distTotal);
+        
+        // Sphere tracing: the segment is free within the clearance of each point
+        double *stateCurr = new double[numDimensions];
+        double distCurr = 0.0;
+        bool collisionFound = false;
+        while (distCurr < distTotal) {
+            
+            for (int i = 0; i < numDimensions; i++) 
+                stateCurr[i] = stateFromIn[i] + (stateToIn[i] - stateFromIn[i])*distCurr/distTotal;
+            
+            double clearance = distanceField->getClearance (stateCurr);
+            
+            // Close to an obstacle, test the rest of the segment exactly
+            if (clearance < distanceField->getResolution()) {
+                collisionFound = obstacleBVH->isInCollision (stateCurr, stateToIn);
+                break;
+            }
+            
+            distCurr += clearance;
+        }
         
-        if (IsInCollision (stateCurr))  
-            return 0;
+        delete [] stateCurr;
         
-        for (int i = 0; i < numDimensions; i++)
-            stateCurr[i] += dists[i];     
+        return collisionFound;
     }
     
-    if (IsInCollision (stateTowardsIn.x))
+    return isEdgeInCollision (*this, &System::IsInCollision, stateFromIn, stateToIn, numDimensions, discretizationStep);
+}
+
+
+int System::setCollisionCheckingMode (int collisionCheckingModeIn) {
+    
+    if ( (collisionCheckingModeIn != COLLISION_CHECKING_DISCRETIZED) && (collisionCheckingModeIn != COLLISION_CHECKING_ANALYTIC)
+         && (collisionCheckingModeIn != COLLISION_CHECKING_DISTANCE_FIELD) )
+        return 0;
+    
+    collisionCheckingMode = collisionCheckingModeIn;
+    
+    obstacleIndexDirty = true;
+    
+    return 1;
+}
+
+
+int System::setDistanceFieldResolution (double resolutionIn) {
+    
+    if (resolutionIn <= 0.0)
         return 0;
     
-    trajectoryOut.endState = new State (stateTowardsIn);
-    trajectoryOut.totalVariation = distTotal; 
+    distanceFieldResolution = resolutionIn;
     
-    delete [] dists;
-    delete [] stateCurr;
+    obstacleIndexDirty = true;
+    
+    return 1;
+}
+
+
+int System::setRGDMode (int rgdModeIn) {
+    
+    if ( (rgdModeIn != RGD_AXIS_STEPS) && (rgdModeIn != RGD_POTENTIAL_FIELD) )
+        return 0;
+    
+    rgdMode = rgdModeIn;
+    
+    obstacleIndexDirty = true;
+    
+    return 1;
+}
+
+
+int System::setPotentialFieldParameters (double resolutionIn, double influenceDistanceIn, double repulsiveGainIn) {
+    
+    if ( (resolutionIn <= 0.0) || (influenceDistanceIn <= 0.0) || (repulsiveGainIn < 0.0) )
+        return 0;
+    
+    potentialFieldResolution = resolutionIn;
+    potentialFieldInfluenceDistance = influenceDistanceIn;
+    potentialFieldRepulsiveGain = repulsiveGainIn;
+    
+    obstacleIndexDirty = true;
+    
+    return 1;
+}
+
+
+int System::setMaxExtensionLength (double maxExtensionLengthIn) {
+    
+    if (maxExtensionLengthIn <= 0.0)
+        return 0;
+    
+    maxExtensionLength = maxExtensionLengthIn;
+    
+    return 1;
+}
+
+
+int System::steerState (State &stateFromIn, State &stateTowardsInOut) {
+    
+    double distTotal = 0.0;
+    for (int i = 0; i < numDimensions; i++) {
+        double distCurr = stateTowardsInOut.x[i] - stateFromIn.x[i];
+        distTotal += distCurr*distCurr;
+    }
+    distTotal = sqrt (distTotal);
+    
+    if (distTotal <= maxExtensionLength)
+        return 1;
+    
+    double ratio = maxExtensionLength/distTotal;
+    for (int i = 0; i < numDimensions; i++) 
+        stateTowardsInOut.x[i] = stateFromIn.x[i] + (stateTowardsInOut.x[i] - stateFromIn.x[i])*ratio;
+    
+    return 1;
+}
+
+
+int System::extendTo (State &stateFromIn, State &stateTowardsIn, Trajectory &trajectoryOut, bool &exactConnectionOut) {
+    
+    if (IsInCollision (stateFromIn.x, stateTowardsIn.x))
+        return 0;
+    
+    double distTotal = 0.0;
+    for (int i = 0; i < numDimensions; i++) {
+        double distCurr = stateTowardsIn.x[i] - stateFromIn.x[i];
+        distTotal += distCurr*distCurr;
+    }
+    
+    if (trajectoryOut.endState)
+        *(trajectoryOut.endState) = stateTowardsIn;
+    else
+        trajectoryOut.endState = new State (stateTowardsIn);
+    trajectoryOut.totalVariation = sqrt (distTotal); 
     
     exactConnectionOut = true;
     
@@ -356,6 +975,28 @@ double System::evaluateExtensionCost (State& stateFromIn, State& stateTowardsIn,
 }
 
 
+int System::evaluateExtensionCosts (State& stateIn, State** statesIn, int numStatesIn, bool, 
+                                    double *costsOut, bool *exactConnectionsOut) {
+    
+    // The straight line distance does not depend on the direction
+    const double *coordinatesIn = stateIn.x;
+    for (int k = 0; k < numStatesIn; k++) {
+        
+        const double *coordinates = statesIn[k]->x;
+        double distTotal = 0.0;
+        for (int i = 0; i < numDimensions; i++) {
+            double distCurr = coordinates[i] - coordinatesIn[i];
+            distTotal += distCurr*distCurr;
+        }
+        
+        costsOut[k] = sqrt (distTotal);
+        exactConnectionsOut[k] = true;
+    }
+    
+    return 1;
+}
+
+
 int System::getTrajectory (State& stateFromIn, State& stateToIn, list<double*>& trajectoryOut) {
     
     double *stateArr = new double[numDimensions];
@@ -370,15 +1011,162 @@ int System::getTrajectory (State& stateFromIn, State& stateToIn, list<double*>&
 
 double System::evaluateCostToGo (State& stateIn) {
     
-    double radius = 0.0;
-    for (int i = 0; i < numDimensions; i++) 
-        radius += regionGoal.size[i] * regionGoal.size[i];
-    radius = sqrt(radius);
+    // The bound of the nearest goal region
+    double distGoal = EvaluateDistanceToRegion (stateIn.x, regionGoal);
+    for (list<region*>::iterator iter = goalRegions.begin(); iter != goalRegions.end(); iter++) {
+        double distCurr = EvaluateDistanceToRegion (stateIn.x, **iter);
+        if (distCurr < distGoal)
+            distGoal = distCurr;
+    }
     
-    double dist = 0.0;
-    for (int i = 0; i < numDimensions; i++) 
-        dist += (stateIn[i] - regionGoal.center[i])*(stateIn[i] - regionGoal.center[i]); 
-    dist = sqrt(dist);
+    if (costToGoMode == COST_TO_GO_NAVIGATION_FIELD) {
+        
+        if ( obstacleIndexDirty || (obstacleBVH->getNumObstacles() != (int)obstacles.size()) )
+            updateObstacleIndex ();
+        
+        // Both bound the cost from below, the path distance is the larger one behind the obstacles
+        double distPath = navigationFieldGoal->getDistance (stateIn.x);
+        if (distPath > distGoal)
+            return distPath;
+    }
     
-    return dist - radius;
+    return distGoal;
+}
+
+
+region* System::copyRegion (region &regionIn) {
+    
+    region *regionNew = new region;
+    regionNew->setNumDimensions (numDimensions);
+    for (int i = 0; i < numDimensions; i++) {
+        regionNew->center[i] = regionIn.center[i];
+        regionNew->size[i] = regionIn.size[i];
+    }
+    
+    return regionNew;
+}
+
+
+int System::addObstacle (region *obstacleIn) {
+    
+    obstacles.push_front (obstacleIn);
+    regionsBlocked.push_back (copyRegion (*obstacleIn));
+    
+    obstacleIndexDirty = true;
+    
+    return 1;
+}
+
+
+int System::removeObstacle (region *obstacleIn) {
+    
+    for (list<region*>::iterator iter = obstacles.begin(); iter != obstacles.end(); iter++) {
+        if (*iter == obstacleIn) {
+            obstacles.erase (iter);
+            regionsFreed.push_back (copyRegion (*obstacleIn));
+            obstacleIndexDirty = true;
+            return 1;
+        }
+    }
+    
+    return 0;
+}
+
+
+int System::addGoalRegion (region *regionIn) {
+    
+    goalRegions.push_back (regionIn);
+    
+    obstacleIndexDirty = true;
+    
+    return 1;
+}
+
+
+int System::removeGoalRegion (region *regionIn) {
+    
+    for (list<region*>::iterator iter = goalRegions.begin(); iter != goalRegions.end(); iter++) {
+        if (*iter == regionIn) {
+            goalRegions.erase (iter);
+            obstacleIndexDirty = true;
+            return 1;
+        }
+    }
+    
+    return 0;
+}
+
+
+int System::moveObstacle (region *obstacleIn, double *centerIn) {
+    
+    regionsFreed.push_back (copyRegion (*obstacleIn));
+    
+    for (int i = 0; i < numDimensions; i++)
+        obstacleIn->center[i] = centerIn[i];
+    
+    regionsBlocked.push_back (copyRegion (*obstacleIn));
+    
+    obstacleIndexDirty = true;
+    
+    return 1;
+}
+
+
+bool System::IsBlockedByObstacleUpdate (double *stateFromIn, double *stateToIn) {
+    
+    for (list<region*>::iterator iter = regionsBlocked.begin(); iter != regionsBlocked.end(); iter++) 
+        if (IsInRegion (stateFromIn, stateToIn, **iter))
+            return true;
+    
+    return false;
+}
+
+
+bool System::isBlockedByObstacleUpdate (State& stateFromIn, State& stateToIn) {
+    
+    return IsBlockedByObstacleUpdate (stateFromIn.x, stateToIn.x);
+}
+
+
+bool System::IsNearFreedRegion (double *stateIn, double keyRadiusIn) {
+    
+    for (list<region*>::iterator iter = regionsFreed.begin(); iter != regionsFreed.end(); iter++) {
+        
+        region *regionCurr = *iter;
+        
+        // Distance between the state key and the freed region in the state key space
+        double dist = 0.0;
+        for (int i = 0; i < numDimensions; i++) {
+            double distCurr = fabs(stateIn[i] - regionCurr->center[i]) - regionCurr->size[i]/2.0;
+            if (distCurr > 0.0) {
+                distCurr /= regionOperating.size[i];
+                dist += distCurr*distCurr;
+            }
+        }
+        
+        if (dist <= keyRadiusIn*keyRadiusIn)
+            return true;
+    }
+    
+    return false;
+}
+
+
+bool System::isNearFreedRegion (State& stateIn, double keyRadiusIn) {
+    
+    return IsNearFreedRegion (stateIn.x, keyRadiusIn);
+}
+
+
+int System::clearObstacleUpdates () {
+    
+    for (list<region*>::iterator iter = regionsBlocked.begin(); iter != regionsBlocked.end(); iter++) 
+        delete *iter;
+    regionsBlocked.clear();
+    
+    for (list<region*>::iterator iter = regionsFreed.begin(); iter != regionsFreed.end(); iter++) 
+        delete *iter;
+    regionsFreed.clear();
+    
+    return 1;
 }
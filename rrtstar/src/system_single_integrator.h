@@ -6,12 +6,61 @@
 #define __RRTS_SYSTEM_SINGLE_INTEGRATOR_H_
 
 #include <list>
+#include <vector>
+
+#include "system_traits.h"
+#include "sampler.h"
 
 
 
 namespace SingleIntegrator {
 
     
+    /*!
+     * \brief Collision checking modes for the edges of the system
+     *
+     * COLLISION_CHECKING_DISCRETIZED checks points along the edge by
+     * hierarchical bisection, down to half the smallest obstacle extent.
+     * COLLISION_CHECKING_ANALYTIC intersects the edge with each obstacle box
+     * exactly (slab test). COLLISION_CHECKING_DISTANCE_FIELD
+     * sphere traces the edge through a precomputed signed distance field and
+     * falls back to the exact test close to the obstacles.
+     */
+    enum {
+        COLLISION_CHECKING_DISCRETIZED = 0,
+        COLLISION_CHECKING_ANALYTIC = 1,
+        COLLISION_CHECKING_DISTANCE_FIELD = 2
+    };
+    
+    
+    /*!
+     * \brief Gradient descent modes for the samples of the system
+     *
+     * RGD_AXIS_STEPS moves the sample by a fixed step along each axis towards
+     * the center of the goal region until it would collide. RGD_POTENTIAL_FIELD
+     * follows the gradient of a precomputed attractive and repulsive potential
+     * field with an adaptive step size until the potential stops decreasing.
+     */
+    enum {
+        RGD_AXIS_STEPS = 0,
+        RGD_POTENTIAL_FIELD = 1
+    };
+    
+    
+    /*!
+     * \brief Cost-to-go modes of the system
+     *
+     * COST_TO_GO_EUCLIDEAN bounds the cost to go with the straight line
+     * distance to the goal region. COST_TO_GO_NAVIGATION_FIELD also uses the
+     * shortest path distance around the obstacles from a precomputed
+     * navigation field, which is much larger behind the obstacles.
+     */
+    enum {
+        COST_TO_GO_EUCLIDEAN = 0,
+        COST_TO_GO_NAVIGATION_FIELD = 1
+    };
+
+    
     /*!
      * \brief region class
      *
@@ -64,6 +113,13 @@ namespace SingleIntegrator {
     
 
     
+    class ObstacleBVH;
+    class DistanceField;
+    class PotentialField;
+    class NavigationField;
+    class OccupancyGridSystem;
+    
+
     /*!
      * \brief State Class.
      *
@@ -106,6 +162,20 @@ namespace SingleIntegrator {
          */
         State& operator= (const State& stateIn);
         
+        /*!
+         * \brief State move constructor
+         *
+         * Takes over the coordinates of stateIn, which is left without dimensions.
+         */
+        State (State&& stateIn);
+        
+        /*!
+         * \brief State move assignment operator
+         *
+         * Takes over the coordinates of stateIn, which is left without dimensions.
+         */
+        State& operator= (State&& stateIn);
+        
         /*!
          * \brief State bracket operator
          *
@@ -114,6 +184,7 @@ namespace SingleIntegrator {
         double& operator[] (const int i) {return x[i];}
         
         friend class System;
+        friend class OccupancyGridSystem;
         friend class Trajectory;
     };
     
@@ -165,6 +236,26 @@ namespace SingleIntegrator {
          */
         Trajectory& operator= (const Trajectory& trajectoryIn);
         
+        /*!
+         * \brief Trajectory move constructor
+         *
+         * Takes over the end state of trajectoryIn, which is left without an end state.
+         *
+         * \param trajectoryIn The trajectory to be moved.
+         *
+         */
+        Trajectory (Trajectory&& trajectoryIn);
+        
+        /*!
+         * \brief Trajectory move assignment operator
+         *
+         * Takes over the end state of trajectoryIn, which is left without an end state.
+         *
+         * \param trajectoryIn The trajectory to be moved.
+         *
+         */
+        Trajectory& operator= (Trajectory&& trajectoryIn);
+        
         /*!
          * \brief Returns a reference to the end state of this trajectory.
          *
@@ -187,6 +278,7 @@ namespace SingleIntegrator {
         double evaluateCost ();
         
         friend class System;
+        friend class OccupancyGridSystem;
     };
     
     
@@ -199,10 +291,61 @@ namespace SingleIntegrator {
     class System {
         
         int numDimensions;
-        bool IsInCollision (double *stateIn);
+        bool IsInRegion (double *stateFromIn, double *stateToIn, region &regionIn);
+        bool IsInRegion (double *stateIn, region &regionIn);
+        double EvaluateDistanceToRegion (double *stateIn, region &regionIn);
+        int GetGoalRegions (std::list<region*>& regionsOut);
+        
+        int collisionCheckingMode;
+        
+        ObstacleBVH *obstacleBVH;
+        DistanceField *distanceField;
+        double distanceFieldResolution;
+        double discretizationStep;
+        bool obstacleIndexDirty;
+        
+        int rgdMode;
+        PotentialField *potentialField;
+        double potentialFieldResolution;
+        double potentialFieldInfluenceDistance;
+        double potentialFieldRepulsiveGain;
+        int RGDPotentialField (State &stateInOut);
+        unsigned long numRGDSamples;
+        unsigned long numRGDSteps;
+        unsigned long numRGDSamplesMoved;
+        unsigned long numRGDSamplesStopped;
+        
+        double gaussianSamplingRatio;
+        double bridgeSamplingRatio;
+        double narrowPassageDeviation;
+        bool IsBlocked (double *stateIn);
+        
+        int costToGoMode;
+        NavigationField *navigationFieldGoal;
+        NavigationField *navigationFieldRoot;
+        double navigationFieldResolution;
+        double corridorSamplingRatio;
+        double corridorSlack;
+        std::vector<int> corridorCells;
+        int updateCorridor ();
+        
+        double maxExtensionLength;
+        
+        RRTstar::Sampler sampler;
         
         State rootState;
         
+        std::list<region*> regionsBlocked;
+        std::list<region*> regionsFreed;
+        region* copyRegion (region &regionIn);
+        
+    protected:
+        
+        bool IsInCollision (double *stateIn);
+        bool IsInCollision (double *stateFromIn, double *stateToIn);
+        bool IsBlockedByObstacleUpdate (double *stateFromIn, double *stateToIn);
+        bool IsNearFreedRegion (double *stateIn, double keyRadiusIn);
+        
     public:    
         
         /*!
@@ -219,6 +362,15 @@ namespace SingleIntegrator {
          */
         region regionGoal;
         
+        /*!
+         * \brief The goal regions in addition to regionGoal
+         *
+         * A state reaches the target if it lies in regionGoal or in any of
+         * these regions. Use addGoalRegion and removeGoalRegion to change
+         * the list after planning has started.
+         */
+        std::list<region*> goalRegions;
+        
         /*!
          * \brief The list of all obstacles
          *
@@ -240,8 +392,163 @@ namespace SingleIntegrator {
          */
         ~System ();
         
+        /*!
+         * \brief Systems are not copied, they own their obstacle indices and fields
+         *
+         * More elaborate description
+         */
+        System (const System& systemIn) = delete;
+        System& operator= (const System& systemIn) = delete;
+        
         int setNumDimensions (int numDimensionsIn);
         
+        /*!
+         * \brief Sets the collision checking mode for the edges
+         *
+         * The default is COLLISION_CHECKING_ANALYTIC.
+         *
+         * \param collisionCheckingModeIn COLLISION_CHECKING_DISCRETIZED, COLLISION_CHECKING_ANALYTIC
+         *                                or COLLISION_CHECKING_DISTANCE_FIELD
+         *
+         */
+        int setCollisionCheckingMode (int collisionCheckingModeIn);
+        
+        /*!
+         * \brief Sets the cell size of the signed distance field
+         *
+         * Used in COLLISION_CHECKING_DISTANCE_FIELD mode. The field covers the
+         * operating region, so the number of cells grows with the power of the
+         * number of dimensions. The default is 1.0.
+         *
+         * \param resolutionIn The new edge length of a cell
+         *
+         */
+        int setDistanceFieldResolution (double resolutionIn);
+        
+        /*!
+         * \brief Sets the gradient descent mode for the samples
+         *
+         * The default is RGD_AXIS_STEPS.
+         *
+         * \param rgdModeIn RGD_AXIS_STEPS or RGD_POTENTIAL_FIELD
+         *
+         */
+        int setRGDMode (int rgdModeIn);
+        
+        /*!
+         * \brief Returns the number of samples passed to RGD since the last reset
+         *
+         * The RGD statistics are updated by sampleState. When a sample pipeline
+         * calls sampleState, read them after stopping the pipeline.
+         */
+        unsigned long getNumRGDSamples () {return numRGDSamples;}
+        
+        /*!
+         * \brief Returns the number of descent steps taken by RGD since the last reset
+         *
+         * More elaborate description
+         */
+        unsigned long getNumRGDSteps () {return numRGDSteps;}
+        
+        /*!
+         * \brief Returns the number of samples that RGD moved since the last reset
+         *
+         * More elaborate description
+         */
+        unsigned long getNumRGDSamplesMoved () {return numRGDSamplesMoved;}
+        
+        /*!
+         * \brief Returns the number of descents that an obstacle stopped since the last reset
+         *
+         * More elaborate description
+         */
+        unsigned long getNumRGDSamplesStopped () {return numRGDSamplesStopped;}
+        
+        /*!
+         * \brief Sets the RGD statistics to zero
+         *
+         * More elaborate description
+         */
+        int resetRGDStatistics ();
+        
+        /*!
+         * \brief Sets the parameters of the potential field
+         *
+         * Used in RGD_POTENTIAL_FIELD mode. The field is built with the obstacle
+         * index, so call updateObstacleIndex after moving the goal region. The
+         * defaults are a resolution of 1.0, an influence distance of 5.0 and a
+         * repulsive gain of 1.0.
+         *
+         * \param resolutionIn The edge length of a cell
+         * \param influenceDistanceIn The distance beyond which the obstacles do not repel
+         * \param repulsiveGainIn The weight of the repulsive potential
+         *
+         */
+        int setPotentialFieldParameters (double resolutionIn, double influenceDistanceIn, double repulsiveGainIn);
+        
+        /*!
+         * \brief Sets the fractions of the samples drawn near the obstacles
+         *
+         * A fraction of the samples is drawn with Gaussian sampling, which keeps
+         * points next to the obstacle boundaries, and a fraction with the bridge
+         * test, which keeps midpoints between two blocked points and so favors
+         * narrow passages. These samples are not moved by RGD. The rest of the
+         * samples are uniform. The default fractions are zero.
+         *
+         * \param gaussianRatioIn Fraction of Gaussian samples
+         * \param bridgeRatioIn Fraction of bridge test samples
+         * \param deviationIn Standard deviation of the distance between the paired points
+         *
+         */
+        int setNarrowPassageSampling (double gaussianRatioIn, double bridgeRatioIn, double deviationIn);
+        
+        /*!
+         * \brief Sets the cost-to-go mode of the system
+         *
+         * The default is COST_TO_GO_EUCLIDEAN.
+         *
+         * \param costToGoModeIn COST_TO_GO_EUCLIDEAN or COST_TO_GO_NAVIGATION_FIELD
+         *
+         */
+        int setCostToGoMode (int costToGoModeIn);
+        
+        /*!
+         * \brief Sets the cell size of the navigation fields
+         *
+         * Used in COST_TO_GO_NAVIGATION_FIELD mode and by the corridor sampling.
+         * The fields are built with the obstacle index, so call
+         * updateObstacleIndex after moving the goal region or the root state.
+         * The default is 1.0.
+         *
+         * \param resolutionIn The new edge length of a cell
+         *
+         */
+        int setNavigationFieldResolution (double resolutionIn);
+        
+        /*!
+         * \brief Sets the fraction of the samples drawn from the corridor of short paths
+         *
+         * The corridor is the set of navigation field cells whose shortest path
+         * distance from the root state plus shortest path distance to the goal
+         * region is at most (1 + slackIn) times the shortest path distance
+         * between the root state and the goal region. The default fraction is
+         * zero.
+         *
+         * \param ratioIn Fraction of the samples drawn uniformly from the corridor
+         * \param slackIn Relative slack of the corridor, zero or larger
+         *
+         */
+        int setCorridorSampling (double ratioIn, double slackIn);
+        
+        /*!
+         * \brief Rebuilds the bounding volume hierarchy and the distance field over the obstacles
+         *
+         * The index is rebuilt automatically when obstacles are added, moved or
+         * removed through the System, or when the number of obstacles changes.
+         * Call this after modifying an obstacle or the operating region directly.
+         */
+        int updateObstacleIndex ();
+        
         /*!
          * \brief Returns the dimensionality of the Euclidean space.
          *
@@ -249,6 +556,14 @@ namespace SingleIntegrator {
          */
         int getNumDimensions () {return numDimensions;}
         
+        /*!
+         * \brief Returns the sampler that draws the sample states
+         *
+         * Seed it or change its sequence to reproduce runs or to give each
+         * planner its own stream.
+         */
+        RRTstar::Sampler& getSampler () {return sampler;}
+        
         /*!
          * \brief Returns a reference to the root state.
          *
@@ -256,6 +571,17 @@ namespace SingleIntegrator {
          */
         State& getRootState () {return rootState;}
         
+        /*!
+         * \brief Sets the root state.
+         *
+         * The corridor of the corridor sampling runs from the root state to
+         * the goal, so it is rebuilt with the next sample.
+         *
+         * \param stateIn The state of the root
+         *
+         */
+        int setRootState (State& stateIn);
+        
         /*!
          * \brief Returns the statekey for the given state.
          *
@@ -290,6 +616,57 @@ namespace SingleIntegrator {
          */
         int sampleState (State &randomStateOut); 
 
+        /*!
+         * \brief Returns a sample state from the goal region.
+         *
+         * A more elaborate description.
+         *
+         * \param randomStateOut
+         *
+         */
+        int sampleGoalState (State &randomStateOut);
+
+        /*!
+         * \brief Returns a sample state from the goal region, drawn with the given sampler.
+         *
+         * Does not touch the sampler of the system, so a planner can draw goal
+         * states while a sample pipeline calls sampleState in another thread.
+         *
+         * \param randomStateOut
+         * \param samplerIn The sampler that draws the state
+         *
+         */
+        int sampleGoalState (State &randomStateOut, RRTstar::Sampler &samplerIn);
+        
+        /*!
+         * \brief Sets the maximum length of an extension
+         *
+         * The default is HUGE_VAL, i.e., samples are connected at any distance.
+         *
+         * \param maxExtensionLengthIn The new maximum length, larger than zero
+         *
+         */
+        int setMaxExtensionLength (double maxExtensionLengthIn);
+        
+        /*!
+         * \brief Returns the maximum length of an extension
+         *
+         * A more elaborate description.
+         */
+        double getMaxExtensionLength () {return maxExtensionLength;}
+        
+        /*!
+         * \brief Moves stateTowardsInOut along the straight line towards stateFromIn until
+         *        it is within the maximum extension length of stateFromIn.
+         *
+         * A more elaborate description.
+         *
+         * \param stateFromIn The state to steer from
+         * \param stateTowardsInOut The state to be truncated
+         *
+         */
+        int steerState (State &stateFromIn, State &stateTowardsInOut);
+        
         
         /*!
          * \brief Returns a the cost of the trajectory that connects stateFromIn and
@@ -321,6 +698,23 @@ namespace SingleIntegrator {
          */
         double evaluateExtensionCost (State &stateFromIn, State &stateTowardsIn, bool &exactConnectionOut);
         
+        /*!
+         * \brief Returns the costs of the trajectories between stateIn and each of the states
+         *
+         * The straight line distance does not depend on the direction, so
+         * fromStateIn is ignored.
+         *
+         * \param stateIn The common end state
+         * \param statesIn The other end states, an array of numStatesIn pointers
+         * \param numStatesIn Number of the other end states
+         * \param fromStateIn Set to true if the trajectories start at stateIn
+         * \param costsOut The costs, an array of dimension numStatesIn
+         * \param exactConnectionsOut Set to true where the states can be connected exactly
+         *
+         */
+        int evaluateExtensionCosts (State &stateIn, State **statesIn, int numStatesIn, bool fromStateIn, 
+                                    double *costsOut, bool *exactConnectionsOut);
+        
         /*!
          * \brief Returns a lower bound on the cost to go starting from stateIn
          *
@@ -343,6 +737,115 @@ namespace SingleIntegrator {
          */
         int getTrajectory (State& stateFromIn, State& stateToIn, std::list<double*>& trajectoryOut);
         
+        /*!
+         * \brief Adds an obstacle to the environment.
+         *
+         * The region is recorded as blocked until clearObstacleUpdates is called.
+         * The caller keeps the ownership of the obstacle.
+         *
+         * \param obstacleIn The new obstacle
+         *
+         */
+        int addObstacle (region *obstacleIn);
+        
+        /*!
+         * \brief Removes an obstacle from the environment.
+         *
+         * The region is recorded as freed until clearObstacleUpdates is called.
+         * The obstacle is not deleted.
+         *
+         * \param obstacleIn The obstacle to be removed
+         *
+         */
+        int removeObstacle (region *obstacleIn);
+        
+        /*!
+         * \brief Adds a goal region to the ones of regionGoal and goalRegions.
+         *
+         * The caller keeps the ownership of the region. Call
+         * Planner::updateGoalVertices afterwards, so that the vertices already
+         * in the region count as goal vertices.
+         *
+         * \param regionIn The new goal region
+         *
+         */
+        int addGoalRegion (region *regionIn);
+        
+        /*!
+         * \brief Removes a goal region from goalRegions.
+         *
+         * The region is not deleted. Call Planner::updateGoalVertices
+         * afterwards, so that the vertices in the region no longer count as
+         * goal vertices.
+         *
+         * \param regionIn The goal region to be removed
+         *
+         */
+        int removeGoalRegion (region *regionIn);
+        
+        /*!
+         * \brief Moves an obstacle to a new center.
+         *
+         * The old region is recorded as freed and the new one as blocked.
+         *
+         * \param obstacleIn The obstacle to be moved
+         * \param centerIn The new center, an array of dimension getNumDimensions()
+         *
+         */
+        int moveObstacle (region *obstacleIn, double *centerIn);
+        
+        /*!
+         * \brief Returns true if the trajectory between the two states crosses a
+         *        region that became blocked since the last clearObstacleUpdates.
+         *
+         * A more elaborate description.
+         *
+         * \param stateFromIn Initial state
+         * \param stateToIn Final state
+         *
+         */
+        bool isBlockedByObstacleUpdate (State& stateFromIn, State& stateToIn);
+        
+        /*!
+         * \brief Returns true if the state is within the given radius of a region
+         *        that was freed since the last clearObstacleUpdates.
+         *
+         * A more elaborate description.
+         *
+         * \param stateIn The state
+         * \param keyRadiusIn The radius, measured in the units of the state key
+         *
+         */
+        bool isNearFreedRegion (State& stateIn, double keyRadiusIn);
+        
+        /*!
+         * \brief Returns true if obstacles changed since the last clearObstacleUpdates.
+         *
+         * A more elaborate description.
+         */
+        bool hasObstacleUpdates () {return (regionsBlocked.size() > 0) || (regionsFreed.size() > 0);}
+        
+        /*!
+         * \brief Forgets the recorded obstacle changes.
+         *
+         * A more elaborate description.
+         */
+        int clearObstacleUpdates ();
+        
+    };
+}
+
+
+
+namespace RRTstar {
+    
+    
+    // Straight edges are determined by their end states
+    template<>
+    struct SystemTraits<SingleIntegrator::System> {
+        static const bool storeTrajectories = false;
+        static const bool batchCostQueries = true;
+        static const bool batchCollisionQueries = false;
     };
 }
 
@@ -0,0 +1,362 @@
+/*!
+ * \file system_single_integrator_fixed.h
+ */
+
+#ifndef __RRTS_SYSTEM_SINGLE_INTEGRATOR_FIXED_H_
+#define __RRTS_SYSTEM_SINGLE_INTEGRATOR_FIXED_H_
+
+#include <array>
+#include <list>
+
+#include "system_single_integrator.h"
+
+
+
+namespace SingleIntegratorFixed {
+
+
+    template<int N> class Trajectory;
+    template<int N> class System;
+
+
+    /*!
+     * \brief State Class with a number of dimensions fixed at compile time.
+     *
+     * The coordinates are stored in the object, so copying and assigning a
+     * state does not allocate memory.
+     */
+    template<int N>
+    class State {
+
+        std::array<double,N> x;
+
+    public:
+
+        /*!
+         * \brief State constructor
+         *
+         * More elaborate description
+         */
+        State () {x.fill (0.0);}
+
+        /*!
+         * \brief State bracket operator
+         *
+         * More elaborate description
+         */
+        double& operator[] (const int i) {return x[i];}
+
+        friend class System<N>;
+        friend class Trajectory<N>;
+    };
+
+
+
+    /*!
+     * \brief Trajectory Class with a number of dimensions fixed at compile time.
+     *
+     * The end state is stored in the object, so copying and assigning a
+     * trajectory does not allocate memory.
+     */
+    template<int N>
+    class Trajectory {
+
+        State<N> endState;
+        double totalVariation;
+
+    public:
+
+        /*!
+         * \brief Trajectory constructor
+         *
+         * More elaborate description
+         */
+        Trajectory () : totalVariation (0.0) {}
+
+        /*!
+         * \brief Returns a reference to the end state of this trajectory.
+         *
+         * More elaborate description
+         */
+        State<N>& getEndState () {return endState;}
+
+        /*!
+         * \brief Returns the cost of this trajectory.
+         *
+         * More elaborate description
+         */
+        double evaluateCost () {return totalVariation;}
+
+        friend class System<N>;
+    };
+
+
+
+    /*!
+     * \brief System Class with a number of dimensions fixed at compile time.
+     *
+     * Works on State<N> and Trajectory<N>, and otherwise behaves like
+     * SingleIntegrator::System, whose environment, collision checking modes
+     * and obstacle updates it uses. The operating and goal regions are
+     * created with N dimensions. The potential field, the narrow passage
+     * sampling, the navigation field, the corridor sampling and the
+     * additional goal regions of SingleIntegrator::System are not supported,
+     * and their setters return 0.
+     */
+    template<int N>
+    class System : public SingleIntegrator::System {
+
+        State<N> rootState;
+
+        int RGD (State<N> &stateInOut);
+
+    public:
+
+        /*!
+         * \brief System constructor
+         *
+         * More elaborate description
+         */
+        System ();
+
+        /*!
+         * \brief Sets the number of dimensions, only N is supported
+         *
+         * The states hold exactly N coordinates.
+         *
+         * \param numDimensionsIn N
+         *
+         */
+        int setNumDimensions (int numDimensionsIn);
+
+        /*!
+         * \brief Sets the lower bound on the cost to go, only COST_TO_GO_EUCLIDEAN is supported
+         *
+         * The navigation field is not used, so the setter returns 0 for
+         * COST_TO_GO_NAVIGATION_FIELD.
+         *
+         * \param costToGoModeIn COST_TO_GO_EUCLIDEAN
+         *
+         */
+        int setCostToGoMode (int costToGoModeIn);
+
+        /*!
+         * \brief Sets the gradient descent of the samples, only RGD_AXIS_STEPS is supported
+         *
+         * The potential field is not used, so the setter returns 0 for
+         * RGD_POTENTIAL_FIELD.
+         *
+         * \param rgdModeIn RGD_AXIS_STEPS
+         *
+         */
+        int setRGDMode (int rgdModeIn);
+
+        /*!
+         * \brief Sets the corridor sampling, only a zero ratio is supported
+         *
+         * The samples are not drawn in the corridor, so the setter returns 0
+         * for a positive ratio.
+         *
+         * \param ratioIn The fraction of the samples, zero
+         * \param slackIn The slack of the corridor
+         *
+         */
+        int setCorridorSampling (double ratioIn, double slackIn);
+
+        /*!
+         * \brief Sets the narrow passage sampling, only zero ratios are supported
+         *
+         * The samples are drawn uniformly, so the setter returns 0 for a
+         * positive Gaussian or bridge test ratio.
+         *
+         * \param gaussianRatioIn The fraction of the samples drawn with Gaussian sampling, zero
+         * \param bridgeRatioIn The fraction of the samples drawn with the bridge test, zero
+         * \param deviationIn The standard deviation of the pair offsets
+         *
+         */
+        int setNarrowPassageSampling (double gaussianRatioIn, double bridgeRatioIn, double deviationIn);
+
+        /*!
+         * \brief Returns 0, this system only reaches regionGoal
+         *
+         * A more elaborate description.
+         */
+        int addGoalRegion (SingleIntegrator::region *regionIn);
+
+        /*!
+         * \brief Returns the dimensionality of the Euclidean space.
+         *
+         * A more elaborate description.
+         */
+        int getNumDimensions () {return N;}
+
+        /*!
+         * \brief Returns a reference to the root state.
+         *
+         * A more elaborate description.
+         */
+        State<N>& getRootState () {return rootState;}
+
+        /*!
+         * \brief Sets the root state.
+         *
+         * A more elaborate description.
+         */
+        int setRootState (State<N>& stateIn) {rootState = stateIn; return 1;}
+
+        /*!
+         * \brief Returns the statekey for the given state.
+         *
+         * A more elaborate description.
+         *
+         * \param stateIn the given state
+         * \param stateKey the key to the state. An array of dimension N
+         *
+         */
+        int getStateKey (State<N> &stateIn, double *stateKey);
+
+        /*!
+         * \brief Returns true of the given state reaches the target.
+         *
+         * A more elaborate description.
+         */
+        bool isReachingTarget (State<N> &stateIn);
+
+        /*!
+         * \brief Returns a sample state, moved towards the goal by randomized gradient descent.
+         *
+         * A more elaborate description.
+         *
+         * \param randomStateOut
+         *
+         */
+        int sampleState (State<N> &randomStateOut);
+
+        /*!
+         * \brief Returns a sample state from the goal region.
+         *
+         * A more elaborate description.
+         *
+         * \param randomStateOut
+         *
+         */
+        int sampleGoalState (State<N> &randomStateOut);
+
+        /*!
+         * \brief Returns a sample state from the goal region, drawn with the given sampler.
+         *
+         * Does not touch the sampler of the system.
+         *
+         * \param randomStateOut
+         * \param samplerIn The sampler that draws the state
+         *
+         */
+        int sampleGoalState (State<N> &randomStateOut, RRTstar::Sampler &samplerIn);
+
+        /*!
+         * \brief Moves stateTowardsInOut along the straight line towards stateFromIn until
+         *        it is within the maximum extension length of stateFromIn.
+         *
+         * A more elaborate description.
+         *
+         * \param stateFromIn The state to steer from
+         * \param stateTowardsInOut The state to be truncated
+         *
+         */
+        int steerState (State<N> &stateFromIn, State<N> &stateTowardsInOut);
+
+        /*!
+         * \brief Returns a the cost of the trajectory that connects stateFromIn and
+         *        stateTowardsIn. The trajectory is also returned in trajectoryOut.
+         *
+         * A more elaborate description.
+         *
+         * \param stateFromIn Initial state
+         * \param stateTowardsIn Final state
+         * \param trajectoryOut Trajectory that starts the from the initial state and
+         *                      reaches near the final state.
+         * \param exactConnectionOut Set to true if the initial and the final states
+         *                           can be connected exactly.
+         *
+         */
+        int extendTo (State<N> &stateFromIn, State<N> &stateTowardsIn,
+                      Trajectory<N> &trajectoryOut, bool &exactConnectionOut);
+
+        /*!
+         * \brief Returns the cost of the trajectory that connects stateFromIn and StateTowardsIn.
+         *
+         * A more elaborate description.
+         *
+         * \param stateFromIn Initial state
+         * \param stateTowardsIn Final state
+         * \param exactConnectionOut Set to true if the initial and the final states
+         *                           can be connected exactly.
+         *
+         */
+        double evaluateExtensionCost (State<N> &stateFromIn, State<N> &stateTowardsIn, bool &exactConnectionOut);
+
+        /*!
+         * \brief Returns a lower bound on the cost to go starting from stateIn
+         *
+         * A more elaborate description.
+         *
+         * \param stateIn Starting state
+         *
+         */
+        double evaluateCostToGo (State<N>& stateIn);
+
+        /*!
+         * \brief Returns the trajectory as a list of double arrays, each with dimension N.
+         *
+         * A more elaborate description.
+         *
+         * \param stateFromIn Initial state
+         * \param stateToIn Final state
+         * \param trajectoryOut The list of double arrays that represent the trajectory
+         *
+         */
+        int getTrajectory (State<N>& stateFromIn, State<N>& stateToIn, std::list<double*>& trajectoryOut);
+
+        /*!
+         * \brief Returns true if the trajectory between the two states crosses a
+         *        region that became blocked since the last clearObstacleUpdates.
+         *
+         * A more elaborate description.
+         *
+         * \param stateFromIn Initial state
+         * \param stateToIn Final state
+         *
+         */
+        bool isBlockedByObstacleUpdate (State<N>& stateFromIn, State<N>& stateToIn);
+
+        /*!
+         * \brief Returns true if the state is within the given radius of a region
+         *        that was freed since the last clearObstacleUpdates.
+         *
+         * A more elaborate description.
+         *
+         * \param stateIn The state
+         * \param keyRadiusIn The radius, measured in the units of the state key
+         *
+         */
+        bool isNearFreedRegion (State<N>& stateIn, double keyRadiusIn);
+    };
+}
+
+
+
+
+namespace RRTstar {
+
+
+    // Straight edges are determined by their end states
+    template<int N>
+    struct SystemTraits< SingleIntegratorFixed::System<N> > {
+        static const bool storeTrajectories = false;
+        static const bool batchCostQueries = false;
+        static const bool batchCollisionQueries = false;
+    };
+}
+
+
+#endif
@@ -0,0 +1,324 @@
+/*!
+ * \file system_single_integrator_fixed.hpp
+ */
+
+#ifndef __RRTS_SYSTEM_SINGLE_INTEGRATOR_FIXED_HPP_
+#define __RRTS_SYSTEM_SINGLE_INTEGRATOR_FIXED_HPP_
+
+#include <cmath>
+#include <cstdlib>
+
+
+#include "system_single_integrator_fixed.h"
+
+
+
+template<int N>
+SingleIntegratorFixed::System<N>
+::System () {
+
+    setNumDimensions (N);
+
+    regionOperating.setNumDimensions (N);
+    regionGoal.setNumDimensions (N);
+    for (int i = 0; i < N; i++) {
+        regionOperating.center[i] = 0.0;
+        regionOperating.size[i] = 0.0;
+        regionGoal.center[i] = 0.0;
+        regionGoal.size[i] = 0.0;
+    }
+}
+
+
+template<int N>
+int
+SingleIntegratorFixed::System<N>
+::setNumDimensions (int numDimensionsIn) {
+
+    if (numDimensionsIn != N)
+        return 0;
+
+    return SingleIntegrator::System::setNumDimensions (N);
+}
+
+
+template<int N>
+int
+SingleIntegratorFixed::System<N>
+::setCostToGoMode (int costToGoModeIn) {
+
+    if (costToGoModeIn != SingleIntegrator::COST_TO_GO_EUCLIDEAN)
+        return 0;
+
+    return SingleIntegrator::System::setCostToGoMode (costToGoModeIn);
+}
+
+
+template<int N>
+int
+SingleIntegratorFixed::System<N>
+::setRGDMode (int rgdModeIn) {
+
+    if (rgdModeIn != SingleIntegrator::RGD_AXIS_STEPS)
+        return 0;
+
+    return SingleIntegrator::System::setRGDMode (rgdModeIn);
+}
+
+
+template<int N>
+int
+SingleIntegratorFixed::System<N>
+::setCorridorSampling (double ratioIn, double slackIn) {
+
+    if (ratioIn > 0.0)
+        return 0;
+
+    return SingleIntegrator::System::setCorridorSampling (ratioIn, slackIn);
+}
+
+
+template<int N>
+int
+SingleIntegratorFixed::System<N>
+::setNarrowPassageSampling (double gaussianRatioIn, double bridgeRatioIn, double deviationIn) {
+
+    if ( (gaussianRatioIn > 0.0) || (bridgeRatioIn > 0.0) )
+        return 0;
+
+    return SingleIntegrator::System::setNarrowPassageSampling (gaussianRatioIn, bridgeRatioIn, deviationIn);
+}
+
+
+template<int N>
+int
+SingleIntegratorFixed::System<N>
+::addGoalRegion (SingleIntegrator::region *) {
+
+    return 0;
+}
+
+
+template<int N>
+int
+SingleIntegratorFixed::System<N>
+::getStateKey (State<N>& stateIn, double* stateKey) {
+
+    for (int i = 0; i < N; i++)
+        stateKey[i] =  stateIn.x[i] / regionOperating.size[i];
+
+    return 1;
+}
+
+
+template<int N>
+bool
+SingleIntegratorFixed::System<N>
+::isReachingTarget (State<N> &stateIn) {
+
+    for (int i = 0; i < N; i++) {
+
+        if (fabs(stateIn.x[i] - regionGoal.center[i]) > regionGoal.size[i]/2.0 )
+            return false;
+    }
+
+    return true;
+}
+
+
+template<int N>
+int
+SingleIntegratorFixed::System<N>
+::RGD (State<N> &stateInOut) {
+
+    int numSteps = 100;
+    double stepSize = 0.05;
+
+    for (int n = 0; n < numSteps; n++) {
+
+        if (isReachingTarget (stateInOut))
+            return 1;
+
+        // Step each coordinate towards the goal, stopping before an obstacle
+        State<N> stateNext (stateInOut);
+        for (int i = 0; i < N; i++) {
+            if (stateInOut.x[i] > regionGoal.center[i])
+                stateNext.x[i] -= stepSize;
+            else if (stateInOut.x[i] < regionGoal.center[i])
+                stateNext.x[i] += stepSize;
+        }
+
+        if (IsInCollision (stateNext.x.data()))
+            return 1;
+
+        stateInOut = stateNext;
+    }
+
+    return 1;
+}
+
+
+template<int N>
+int
+SingleIntegratorFixed::System<N>
+::sampleState (State<N> &randomStateOut) {
+
+    getSampler().samplePoint (randomStateOut.x.data());
+    for (int i = 0; i < N; i++) {
+
+        randomStateOut.x[i] = randomStateOut.x[i]*regionOperating.size[i]
+        - regionOperating.size[i]/2.0 + regionOperating.center[i];
+    }
+
+    if (IsInCollision (randomStateOut.x.data()))
+        return 0;
+
+    RGD (randomStateOut);
+
+    return 1;
+}
+
+
+template<int N>
+int
+SingleIntegratorFixed::System<N>
+::sampleGoalState (State<N> &randomStateOut) {
+
+    return sampleGoalState (randomStateOut, getSampler());
+}
+
+
+template<int N>
+int
+SingleIntegratorFixed::System<N>
+::sampleGoalState (State<N> &randomStateOut, RRTstar::Sampler &samplerIn) {
+
+    for (int i = 0; i < N; i++) {
+
+        randomStateOut.x[i] = samplerIn.sampleUniform ()*regionGoal.size[i]
+        - regionGoal.size[i]/2.0 + regionGoal.center[i];
+    }
+
+    if (IsInCollision (randomStateOut.x.data()))
+        return 0;
+
+    return 1;
+}
+
+
+template<int N>
+int
+SingleIntegratorFixed::System<N>
+::steerState (State<N> &stateFromIn, State<N> &stateTowardsInOut) {
+
+    double distTotal = 0.0;
+    for (int i = 0; i < N; i++) {
+        double distCurr = stateTowardsInOut.x[i] - stateFromIn.x[i];
+        distTotal += distCurr*distCurr;
+    }
+    distTotal = sqrt (distTotal);
+
+    double maxExtensionLength = getMaxExtensionLength ();
+    if (distTotal <= maxExtensionLength)
+        return 1;
+
+    double ratio = maxExtensionLength/distTotal;
+    for (int i = 0; i < N; i++)
+        stateTowardsInOut.x[i] = stateFromIn.x[i] + (stateTowardsInOut.x[i] - stateFromIn.x[i])*ratio;
+
+    return 1;
+}
+
+
+template<int N>
+int
+SingleIntegratorFixed::System<N>
+::extendTo (State<N> &stateFromIn, State<N> &stateTowardsIn, Trajectory<N> &trajectoryOut, bool &exactConnectionOut) {
+
+    if (IsInCollision (stateFromIn.x.data(), stateTowardsIn.x.data()))
+        return 0;
+
+    double distTotal = 0.0;
+    for (int i = 0; i < N; i++) {
+        double distCurr = stateTowardsIn.x[i] - stateFromIn.x[i];
+        distTotal += distCurr*distCurr;
+    }
+
+    trajectoryOut.endState = stateTowardsIn;
+    trajectoryOut.totalVariation = sqrt (distTotal);
+
+    exactConnectionOut = true;
+
+    return 1;
+}
+
+
+template<int N>
+double
+SingleIntegratorFixed::System<N>
+::evaluateExtensionCost (State<N>& stateFromIn, State<N>& stateTowardsIn, bool &exactConnectionOut) {
+
+    exactConnectionOut = true;
+
+    double distTotal = 0.0;
+    for (int i = 0; i < N; i++) {
+        double distCurr = stateTowardsIn.x[i] - stateFromIn.x[i];
+        distTotal += distCurr*distCurr;
+    }
+
+    return sqrt(distTotal);
+}
+
+
+template<int N>
+int
+SingleIntegratorFixed::System<N>
+::getTrajectory (State<N>& stateFromIn, State<N>& stateToIn, std::list<double*>& trajectoryOut) {
+
+    double *stateArr = new double[N];
+    for (int i = 0; i < N; i++)
+        stateArr[i] = stateToIn.x[i];
+    trajectoryOut.push_front (stateArr);
+
+    return 1;
+}
+
+
+template<int N>
+double
+SingleIntegratorFixed::System<N>
+::evaluateCostToGo (State<N>& stateIn) {
+
+    double radius = 0.0;
+    for (int i = 0; i < N; i++)
+        radius += regionGoal.size[i] * regionGoal.size[i];
+    radius = sqrt(radius);
+
+    double dist = 0.0;
+    for (int i = 0; i < N; i++)
+        dist += (stateIn.x[i] - regionGoal.center[i])*(stateIn.x[i] - regionGoal.center[i]);
+    dist = sqrt(dist);
+
+    return dist - radius;
+}
+
+
+template<int N>
+bool
+SingleIntegratorFixed::System<N>
+::isBlockedByObstacleUpdate (State<N>& stateFromIn, State<N>& stateToIn) {
+
+    return IsBlockedByObstacleUpdate (stateFromIn.x.data(), stateToIn.x.data());
+}
+
+
+template<int N>
+bool
+SingleIntegratorFixed::System<N>
+::isNearFreedRegion (State<N>& stateIn, double keyRadiusIn) {
+
+    return IsNearFreedRegion (stateIn.x.data(), keyRadiusIn);
+}
+
+
+#endif
@@ -0,0 +1,37 @@
+/*!
+ * \file system_traits.h
+ */
+
+#ifndef __RRTS_SYSTEM_TRAITS_H_
+#define __RRTS_SYSTEM_TRAITS_H_
+
+
+
+namespace RRTstar {
+
+
+    /*!
+     * \brief Compile-time properties of a dynamical system
+     *
+     * storeTrajectories tells the planners whether to keep the trajectory of
+     * each edge in its end vertex. The planners draw paths with
+     * System::getTrajectory from the states of the vertices, so a system
+     * whose trajectories are determined by their two end states can
+     * specialize the trait to false, which saves one Trajectory per vertex.
+     *
+     * batchCostQueries tells the planners that the system provides
+     * evaluateExtensionCosts, and batchCollisionQueries that it provides
+     * extendToStates. These answer the cost and the collision queries
+     * between one state and all of its near vertices in a single call (see
+     * extension_queries.h).
+     */
+    template<class System>
+    struct SystemTraits {
+        static const bool storeTrajectories = true;
+        static const bool batchCostQueries = false;
+        static const bool batchCollisionQueries = false;
+    };
+}
+
+
+#endif